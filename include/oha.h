@@ -9,11 +9,62 @@ extern "C" {
 #include <stddef.h>
 #include <stdint.h>
 
+/*
+ * Capacity type of the tables and heaps. The compact 32 bit layout is the default. Define OHA_WITH_64BIT_CAPACITY for
+ * the library and all users (e.g. link against the oha_static_64 target) to store more than 2^32 elements in a lpht or
+ * binary heap.
+ */
+#ifdef OHA_WITH_64BIT_CAPACITY
+typedef uint64_t oha_capacity_t;
+#else
+typedef uint32_t oha_capacity_t;
+#endif
+
 struct oha_key_value_pair {
     void * key;
     void * value;
 };
 
+/*
+ * Optional custom memory allocation. If alloc is not set, calloc() and free() are used. The returned memory of alloc
+ * does not need to be zeroed. The free callback is optional, e.g. for arena allocators.
+ */
+struct oha_memory_fp {
+    void * (*alloc)(size_t size, void * context);
+    void (*free)(void * ptr, void * context);
+    void * context;
+};
+
+/**********************************************************************************************************************
+ *  arena allocator
+ *
+ *      - hosts many small tables and heaps in big memory blocks
+ *      - freed memory is reused by following allocations of the same size class
+ *      - all memory is released at once by oha_arena_reset() or oha_arena_destroy()
+ *
+ **********************************************************************************************************************/
+struct oha_arena;
+
+// block_size == 0 selects a default block size
+struct oha_arena * oha_arena_create(size_t block_size);
+void oha_arena_destroy(struct oha_arena * arena);
+void oha_arena_reset(struct oha_arena * arena);
+void * oha_arena_alloc(size_t size, void * arena);
+void oha_arena_free(void * ptr, void * arena);
+struct oha_memory_fp oha_arena_get_memory_fp(struct oha_arena * arena);
+
+/**********************************************************************************************************************
+ *  copy on write snapshots
+ *
+ *      - the cow allocator maps every table into its own page aligned mapping without transparent huge pages
+ *      - after a fork() the parent copies only the 4 KiB pages it writes to, the child sees a stable table
+ *      - oha_lpht_fork_snapshot() runs an export function in a forked child, see the lpht section
+ *
+ **********************************************************************************************************************/
+void * oha_cow_alloc(size_t size, void * context);
+void oha_cow_free(void * ptr, void * context);
+struct oha_memory_fp oha_cow_get_memory_fp(void);
+
 /**********************************************************************************************************************
  *  linear probing hash table (lpht)
  *
@@ -26,26 +77,391 @@ struct oha_lpht_config {
     double load_factor;
     size_t key_size;
     size_t value_size;
-    uint32_t max_elems;
+    oha_capacity_t max_elems;
+    struct oha_memory_fp memory;
+    // enables oha_lpht_get_key_from_value() for this table, costs one pointer per value
+    bool key_from_value;
+    // optional custom hash function, the built-in hash is used if not set
+    uint64_t (*hash_fn)(const void * key, size_t key_size);
+    /*
+     * Optional blocked bloom filter in front of the look ups, so most misses touch only one cache line of the filter.
+     * Bits per element (max 64), about 10 bits give a false positive rate around 1%. 0 disables the filter.
+     */
+    uint32_t filter_bits_per_elem;
+    /*
+     * Stores the 64 bit hash of every key in its bucket, costs 8 bytes per bucket. Rehashes, merges and filter rebuilds
+     * reuse the hashes instead of hashing all keys again, keys of 32 bytes and more are compared by hash first.
+     */
+    bool cache_hashes;
+    /*
+     * Opt-in for oha_lpht_auto_shrink(), the table shrinks if less than shrink_threshold * max_elems elements are in
+     * use. Must be lower than 0.5, 0 disables the shrinking.
+     */
+    double shrink_threshold;
+    // seed of the built-in hash, 0 selects the default seed. Custom hash functions are not seeded.
+    uint64_t seed;
+    /*
+     * Hash flooding monitor of the built-in hash, an insert of a new key which probes more than reseed_probe_length
+     * buckets marks the table for oha_lpht_auto_reseed(). Should be far above the usual probe lengths of the load
+     * factor, 0 disables the monitor. With a max_probe below it, a half full overflow stash marks the table.
+     */
+    uint32_t reseed_probe_length;
+    /*
+     * Upper bound of the probed buckets per operation, 0 disables the bound. Keys which would be placed further away
+     * from their start bucket go into an overflow stash of 32 buckets, which look ups scan after max_probe buckets.
+     * Inserts fail if the stash is full.
+     */
+    uint32_t max_probe;
 };
 
 struct oha_lpht_status {
-    uint32_t max_elems;
-    uint32_t elems_in_use;
+    oha_capacity_t max_elems;
+    oha_capacity_t elems_in_use;
     size_t size_in_bytes;
+    size_t max_probe_distance; // highest distance of an inserted key from its start bucket since creation (lpht only)
+    uint32_t stash_in_use;     // keys in the overflow stash of max_probe tables
+    uint32_t stash_size;       // buckets of the overflow stash, 0 if max_probe is disabled
+};
+
+/*
+ * Cumulative hot path counters, only collected if the library is build with OHA_WITH_STATS. look_ups, hits and misses
+ * cover only the look up calls, the probes of inserts, prepared inserts, merges and removes add to probe_steps and
+ * key_compares without a look up, so per look up ratios of these counters include them.
+ */
+struct oha_lpht_statistics {
+    uint64_t look_ups;             // keys looked up by oha_lpht_look_up(), the batch look ups and the probes
+    uint64_t hits;                 // look ups which found the key
+    uint64_t misses;               // look ups which did not find the key
+    uint64_t probe_steps;          // visited buckets over all operations
+    uint64_t key_compares;         // number of key memcmp calls, keys rejected by their cached hash are not compared
+    uint64_t probify_moves;        // entries moved by the backward shift after a remove
+    uint64_t insert_failures_full; // inserts rejected because the table or its overflow stash was full
+    uint64_t filter_rejects;       // misses answered by the filter without probing the table
+    uint64_t filter_rebuilds;      // filter rebuilds to drop the keys of removed elements
+    uint64_t reseeds;              // rehashes with a new seed by oha_lpht_auto_reseed()
+    uint64_t stash_inserts;        // keys placed in the overflow stash, because max_probe buckets were occupied
 };
 
 size_t oha_lpht_calculate_size(const struct oha_lpht_config * config);
 struct oha_lpht * oha_lpht_initialize(const struct oha_lpht_config * config, void * memory);
 struct oha_lpht * oha_lpht_create(const struct oha_lpht_config * config);
 void oha_lpht_destroy(struct oha_lpht * table);
+/*
+ * Copies the whole table with one memcpy into dst_memory and rebases its internal pointers. dst_memory needs the size
+ * of the source table (see oha_lpht_get_status()), if it is NULL the memory is allocated with the allocator of src.
+ * Only clones allocated by oha_lpht_clone() are released by oha_lpht_destroy(). A clone in dst_memory does not keep the
+ * allocator of src and must not be passed to oha_lpht_destroy(), the caller releases dst_memory itself.
+ */
+struct oha_lpht * oha_lpht_clone(const struct oha_lpht * src, void * dst_memory);
+/*
+ * Moves all elements into a new table for new_max_elems with new_load_factor (0 keeps the load factor) and releases the
+ * old table with its allocator, like realloc(). All pointers into the old table get invalid, the back pointers of
+ * key_from_value tables are moved along. Returns NULL and keeps the old table, if the elements do not fit into
+ * new_max_elems, the allocation fails or the table is in clear mode. Only tables allocated by oha_lpht_create() or
+ * oha_lpht_clone() are rehashed, tables in memory of the caller (oha_lpht_initialize(), clones into dst_memory and the
+ * partition tables of the radix partition and the numa table) always return NULL.
+ */
+struct oha_lpht * oha_lpht_rehash(struct oha_lpht * table, oha_capacity_t new_max_elems, double new_load_factor);
+/*
+ * Rehashes the table to twice the elements in use, if it is below the shrink_threshold of its config. Returns the
+ * table to use from now on, which is the old one if nothing changed or the rehash failed. Tables in memory of the
+ * caller are never rehashed (see oha_lpht_rehash()).
+ */
+struct oha_lpht * oha_lpht_auto_shrink(struct oha_lpht * table);
+/*
+ * Rehashes the table with a new random seed and the same capacity, if an insert exceeded the reseed_probe_length of
+ * its config since the last reseed. Returns the table to use from now on like oha_lpht_auto_shrink(), call it after
+ * inserts at a point where no pointers into the table are held. Tables in memory of the caller are never reseeded
+ * (see oha_lpht_rehash()).
+ */
+struct oha_lpht * oha_lpht_auto_reseed(struct oha_lpht * table);
 void * oha_lpht_look_up(struct oha_lpht * table, const void * key);
+/*
+ * Looks up count keys, stored contiguous with the configured key size, and writes the value pointers (or NULL) to
+ * values. The look ups are processed in groups with prefetched buckets to overlap their cache misses.
+ */
+void oha_lpht_look_up_batch(struct oha_lpht * table, const void * keys, size_t count, void ** values);
+/*
+ * Stepwise look up to interleave many look ups in the callers control flow, e.g. with coroutines. The key must stay
+ * valid until the probe has finished. The probe does not use the bloom filter of the table.
+ */
+struct oha_lpht_probe {
+    const void * key;
+    void * bucket; // the next bucket to visit
+    uint64_t hash;
+    size_t offset; // visited buckets
+};
+// hashes the key and returns the address of the first bucket, which should be prefetched before the first step
+const void * oha_lpht_probe_init(struct oha_lpht * table, struct oha_lpht_probe * probe, const void * key);
+/*
+ * Visits the buckets of one cache line. Returns true if the look up has finished, *value is the found value or NULL.
+ * Returns false if the probe continues at probe->bucket, which should be prefetched before the next step.
+ */
+bool oha_lpht_probe_step(struct oha_lpht * table, struct oha_lpht_probe * probe, void ** value);
 void * oha_lpht_insert(struct oha_lpht * table, const void * key);
-void * oha_lpht_get_key_from_value(const void * value);
+/*
+ * Same as oha_lpht_insert() with one probe sequence, but reports if the key was new. Returns NULL (and inserted is
+ * false) if the key is new and the table is full.
+ */
+void * oha_lpht_insert_ex(struct oha_lpht * table, const void * key, bool * inserted);
+/*
+ * Two phase insert, so the value of a new key is only built if the key is not inserted yet. The prepare call probes
+ * once and returns the value of an inserted key with slot->bucket set to NULL. For a new key it reserves a free bucket
+ * and returns its value to fill, the key is only visible after the commit. The abort drops the reservation, both
+ * finish without probing again. The table must not be modified between prepare and commit. Returns NULL if the table
+ * is full.
+ */
+struct oha_lpht_slot {
+    void * bucket; // the reserved bucket, NULL if the key was found
+    uint64_t hash;
+    size_t offset;
+};
+void * oha_lpht_prepare_insert(struct oha_lpht * table, const void * key, struct oha_lpht_slot * slot);
+// returns the value of the committed key, NULL if nothing was reserved
+void * oha_lpht_commit_insert(struct oha_lpht * table, struct oha_lpht_slot * slot);
+void oha_lpht_abort_insert(struct oha_lpht * table, struct oha_lpht_slot * slot);
+/*
+ * Aggregation fast path for tables with 8 byte values: adds delta to the counter of the key, new keys start with delta.
+ * Returns the counter or NULL, if the key is new and the table is full or the value size is not 8 bytes.
+ */
+uint64_t * oha_lpht_add_u64(struct oha_lpht * table, const void * key, uint64_t delta);
+/*
+ * Adds deltas[i] (1 for all keys if deltas is NULL) to the counters of count keys, stored contiguous with the configured
+ * key size. The buckets and counters of a group of keys are prefetched before they are updated. Returns the number of
+ * added keys, which is lower than count if the table got full.
+ */
+size_t oha_lpht_add_u64_batch(struct oha_lpht * table, const void * keys, const uint64_t * deltas, size_t count);
+// returns the key of a value of table, NULL if table was not configured with key_from_value
+void * oha_lpht_get_key_from_value(const struct oha_lpht * table, const void * value);
 void * oha_lpht_remove(struct oha_lpht * table, const void * key);
+/*
+ * Removes all elements for which pred returns true with one linear pass over the table and returns the number of
+ * removed elements. Must not be mixed with a running clear mode.
+ */
+oha_capacity_t oha_lpht_erase_if(struct oha_lpht * table,
+                                 bool (*pred)(const void * key, void * value, void * context),
+                                 void * context);
+/*
+ * Inserts all elements of src into dst. New keys get a copy of the src value, for existing keys the optional combine
+ * callback is called, e.g. to sum counters. Both tables need the same key and value size and dst should be sized for
+ * the union. Returns false if the tables do not match or dst is full, the merge is incomplete then.
+ */
+bool oha_lpht_merge(struct oha_lpht * dst,
+                    struct oha_lpht * src,
+                    void (*combine)(const void * key, void * dst_value, const void * src_value, void * context),
+                    void * context);
+/*
+ * Same as oha_lpht_merge(), but merges only the keys of one of num_partitions disjoint hash ranges. Threads can merge
+ * the same sources in parallel into one destination table per partition.
+ */
+bool oha_lpht_merge_partition(struct oha_lpht * dst,
+                              struct oha_lpht * src,
+                              void (*combine)(const void * key, void * dst_value, const void * src_value, void * context),
+                              void * context,
+                              uint32_t partition,
+                              uint32_t num_partitions);
+/*
+ * Returns the hash range partition of the key, which is used by oha_lpht_merge_partition(). The partitions are
+ * independent of the seed of the table, tables with the same key size and hash function agree on them.
+ */
+uint32_t oha_lpht_get_partition(struct oha_lpht * table, const void * key, uint32_t num_partitions);
 bool oha_lpht_get_status(struct oha_lpht * table, struct oha_lpht_status * status);
 void oha_lpht_clear(struct oha_lpht * table);
 struct oha_key_value_pair oha_lpht_get_next_element_to_remove(struct oha_lpht * table);
+/*
+ * Iterates over all elements, start with *position = 0. Returns a pair with key == NULL at the end. The table must not
+ * be modified during the iteration.
+ */
+struct oha_key_value_pair oha_lpht_get_next_element(struct oha_lpht * table, size_t * position);
+/*
+ * Forks a child process, which calls export_fn with the table of the fork time and exits with its return value. The
+ * parent continues immediately and may modify the table. Returns the pid of the child for waitpid() or -1 on failure.
+ * Use the cow allocator for the table to keep the copies of the parent small.
+ */
+int oha_lpht_fork_snapshot(struct oha_lpht * table,
+                           int (*export_fn)(struct oha_lpht * table, void * context),
+                           void * context);
+// returns false, if the library was build without OHA_WITH_STATS
+bool oha_lpht_get_statistics(struct oha_lpht * table, struct oha_lpht_statistics * statistics);
+void oha_lpht_reset_statistics(struct oha_lpht * table);
+
+/**********************************************************************************************************************
+ *  bucketized cuckoo hash table (ccht)
+ *
+ *      - two hash choices, each bucket holds 4 slots, small keys fit one bucket into one cache line
+ *      - a look up touches at most two buckets, load factors up to 0.95 and more are possible
+ *      - uses the lpht config and status structures, only load_factor, key_size, value_size, max_elems, memory and
+ *        hash_fn are supported, the create and initialize calls fail if any other option is set
+ *      - an insert of a new key may fail before max_elems is reached, if no displacement path is found
+ *      - limited to 2^32 slots, also with OHA_WITH_64BIT_CAPACITY
+ *
+ **********************************************************************************************************************/
+struct oha_ccht;
+
+size_t oha_ccht_calculate_size(const struct oha_lpht_config * config);
+struct oha_ccht * oha_ccht_initialize(const struct oha_lpht_config * config, void * memory);
+struct oha_ccht * oha_ccht_create(const struct oha_lpht_config * config);
+void oha_ccht_destroy(struct oha_ccht * table);
+void * oha_ccht_look_up(struct oha_ccht * table, const void * key);
+void * oha_ccht_insert(struct oha_ccht * table, const void * key);
+void * oha_ccht_insert_ex(struct oha_ccht * table, const void * key, bool * inserted);
+void * oha_ccht_remove(struct oha_ccht * table, const void * key);
+struct oha_key_value_pair oha_ccht_get_next_element(struct oha_ccht * table, size_t * position);
+bool oha_ccht_get_status(struct oha_ccht * table, struct oha_lpht_status * status);
+
+/**********************************************************************************************************************
+ *  hopscotch hash table (hsht)
+ *
+ *      - every home bucket keeps a 32 bit hop bitmap of its neighborhood
+ *      - a look up touches at most the 32 buckets of one neighborhood, elements are displaced on insert
+ *      - uses the lpht config and status structures, only load_factor, key_size, value_size, max_elems, memory and
+ *        hash_fn are supported, the create and initialize calls fail if any other option is set
+ *      - an insert of a new key may fail before max_elems is reached, if no element could be displaced, keep the load
+ *        factor at about 0.8 or below
+ *      - limited to 2^32 buckets, also with OHA_WITH_64BIT_CAPACITY
+ *
+ **********************************************************************************************************************/
+struct oha_hsht;
+
+size_t oha_hsht_calculate_size(const struct oha_lpht_config * config);
+struct oha_hsht * oha_hsht_initialize(const struct oha_lpht_config * config, void * memory);
+struct oha_hsht * oha_hsht_create(const struct oha_lpht_config * config);
+void oha_hsht_destroy(struct oha_hsht * table);
+void * oha_hsht_look_up(struct oha_hsht * table, const void * key);
+void * oha_hsht_insert(struct oha_hsht * table, const void * key);
+void * oha_hsht_insert_ex(struct oha_hsht * table, const void * key, bool * inserted);
+void * oha_hsht_remove(struct oha_hsht * table, const void * key);
+struct oha_key_value_pair oha_hsht_get_next_element(struct oha_hsht * table, size_t * position);
+bool oha_hsht_get_status(struct oha_hsht * table, struct oha_lpht_status * status);
+
+/**********************************************************************************************************************
+ *  NUMA aware partitioned linear probing hash table (numa_lpht)
+ *
+ *      - splits the hash range into partitions, every partition is a lpht placed on one NUMA node
+ *      - keys are routed by a separate hash to their partition, e.g. to let threads work on node local partitions
+ *      - the interleave policy spreads the pages of every partition over all nodes instead
+ *      - memory is mapped from the kernel and bound with mbind(), config.table.memory is ignored
+ *      - placement is best effort, on other systems than Linux or on failing syscalls the memory is not bound
+ *
+ **********************************************************************************************************************/
+enum oha_numa_policy {
+    OHA_NUMA_PARTITIONED, // partitions are placed round robin on the online nodes
+    OHA_NUMA_INTERLEAVED, // the pages of all partitions are interleaved over the online nodes
+};
+
+struct oha_numa_config {
+    // max_elems is the capacity of the whole table, every partition adds a small slack for the hash imbalance
+    struct oha_lpht_config table;
+    enum oha_numa_policy policy;
+    uint32_t partitions; // 0 selects one partition per online node
+};
+
+struct oha_numa_lpht;
+
+// returns the number of online NUMA nodes, 1 if the system has no NUMA support
+uint32_t oha_numa_get_num_nodes(void);
+struct oha_numa_lpht * oha_numa_lpht_create(const struct oha_numa_config * config);
+void oha_numa_lpht_destroy(struct oha_numa_lpht * table);
+void * oha_numa_lpht_look_up(struct oha_numa_lpht * table, const void * key);
+void * oha_numa_lpht_insert(struct oha_numa_lpht * table, const void * key);
+void * oha_numa_lpht_insert_ex(struct oha_numa_lpht * table, const void * key, bool * inserted);
+void * oha_numa_lpht_remove(struct oha_numa_lpht * table, const void * key);
+uint32_t oha_numa_lpht_get_num_partitions(struct oha_numa_lpht * table);
+uint32_t oha_numa_lpht_get_partition(struct oha_numa_lpht * table, const void * key);
+// returns the node of the partition or -1 for interleaved partitions
+int oha_numa_lpht_get_partition_node(struct oha_numa_lpht * table, uint32_t partition);
+/*
+ * Direct access to one partition, e.g. for a thread which handles only keys of this partition. The table is borrowed,
+ * it lives in the partition memory of the numa table and is released with it. It must not be passed to
+ * oha_lpht_destroy(), oha_lpht_rehash(), oha_lpht_auto_shrink() or oha_lpht_auto_reseed().
+ */
+struct oha_lpht * oha_numa_lpht_get_partition_table(struct oha_numa_lpht * table, uint32_t partition);
+bool oha_numa_lpht_get_status(struct oha_numa_lpht * table, struct oha_lpht_status * status);
+
+/**********************************************************************************************************************
+ *  hash join (hj)
+ *
+ *      - read only multimap of the build side keys, duplicate keys are chained by their build index
+ *      - an lpht maps every distinct key to the first build index of its chain
+ *      - the probe side is looked up in batches, the matches are written as (build index, probe index) pairs
+ *      - the keys are referenced by index only, the build keys are copied into the lpht
+ *
+ **********************************************************************************************************************/
+#define OHA_HJ_END SIZE_MAX
+
+struct oha_hj_config {
+    double load_factor;
+    size_t key_size;
+    struct oha_memory_fp memory;
+    // optional custom hash function, the built-in hash is used if not set
+    uint64_t (*hash_fn)(const void * key, size_t key_size);
+};
+
+struct oha_hj_match {
+    size_t build_idx;
+    size_t probe_idx;
+};
+
+// resume state of oha_hj_probe(), zero initialized starts at the first probe key
+struct oha_hj_cursor {
+    size_t probe_idx; // next probe key, all probe keys are joined if it reaches the probe count
+    size_t chain;     // internal, the remaining matches of the current probe key
+};
+
+struct oha_hj;
+
+// builds the multimap of build_count keys, stored contiguous with the configured key size
+struct oha_hj * oha_hj_create(const struct oha_hj_config * config, const void * build_keys, size_t build_count);
+void oha_hj_destroy(struct oha_hj * join);
+// returns the lowest build index of the key or OHA_HJ_END
+size_t oha_hj_find(struct oha_hj * join, const void * key);
+// returns the next higher build index with the same key or OHA_HJ_END
+size_t oha_hj_next(struct oha_hj * join, size_t build_idx);
+/*
+ * Joins the probe keys from the cursor position on and writes up to max_matches matches, ordered by probe index and
+ * build index. Returns the number of written matches, call again with the same cursor until the cursor reaches
+ * probe_count.
+ */
+size_t oha_hj_probe(struct oha_hj * join,
+                    const void * probe_keys,
+                    size_t probe_count,
+                    struct oha_hj_cursor * cursor,
+                    struct oha_hj_match * matches,
+                    size_t max_matches);
+
+/**********************************************************************************************************************
+ *  radix partitioning (rp)
+ *
+ *      - scatters rows of keys and optional values by the upper hash bits into 2^radix_bits partitions
+ *      - the scatter goes through cache line sized write combining buffers per partition
+ *      - every partition has its own small lpht, initialized in one shared memory block, so the work on one partition
+ *        stays in the caches, e.g. oha_lpht_add_u64_batch() of its rows into its table
+ *      - the partition tables keep their elements over several oha_rp_partition() calls
+ *      - the partition tables are owned by the rp, they must not be destroyed or rehashed
+ *
+ **********************************************************************************************************************/
+struct oha_rp_config {
+    /*
+     * Config of all partition tables, max_elems is the capacity of all partitions together, every partition adds a small
+     * slack for the hash imbalance. The rows have the key size and the value size of the tables.
+     */
+    struct oha_lpht_config table;
+    uint32_t radix_bits; // up to 14, 0 selects partition tables of about 256 KiB
+};
+
+struct oha_rp;
+
+struct oha_rp * oha_rp_create(const struct oha_rp_config * config);
+void oha_rp_destroy(struct oha_rp * rp);
+uint32_t oha_rp_get_num_partitions(struct oha_rp * rp);
+/*
+ * Partitions count rows, keys and values are stored contiguous, values is optional. The rows of the previous call are
+ * dropped, the partition tables are untouched.
+ */
+bool oha_rp_partition(struct oha_rp * rp, const void * keys, const void * values, size_t count);
+// returns the number of rows of the partition, keys and values point to them (values is NULL without values)
+size_t oha_rp_get_rows(struct oha_rp * rp, uint32_t partition, const void ** keys, const void ** values);
+struct oha_lpht * oha_rp_get_table(struct oha_rp * rp, uint32_t partition);
 
 /**********************************************************************************************************************
  *  binary heap (bh)
@@ -55,7 +471,8 @@ struct oha_key_value_pair oha_lpht_get_next_element_to_remove(struct oha_lpht *
  **********************************************************************************************************************/
 struct oha_bh_config {
     size_t value_size;
-    uint32_t max_elems;
+    oha_capacity_t max_elems;
+    struct oha_memory_fp memory;
 };
 struct oha_bh;
 size_t oha_bh_calculate_size(const struct oha_bh_config * config);
@@ -0,0 +1,580 @@
+#ifndef ORDERED_HASHING_HPP_
+#define ORDERED_HASHING_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#define OHA_WITH_COROUTINES
+#include <coroutine>
+#include <exception>
+#include <vector>
+#endif
+
+#include "oha.h"
+
+/**********************************************************************************************************************
+ *  C++ wrapper
+ *
+ *      - header only, type safe templates around the C API
+ *      - the key size is sizeof(Key) and known at compile time
+ *      - keys are hashed, copied and compared bytewise by the library, values are moved bytewise inside the table
+ *
+ **********************************************************************************************************************/
+namespace oha
+{
+
+// selects the built-in hash function of the library
+struct builtin_hash {
+};
+
+namespace detail
+{
+
+using hash_fn = uint64_t (*)(const void * key, size_t key_size);
+
+template <typename Key, typename Hash> struct hash_adapter {
+    static uint64_t hash(const void * key, size_t key_size)
+    {
+        (void)key_size;
+        return static_cast<uint64_t>(Hash{}(*static_cast<const Key *>(key)));
+    }
+
+    static constexpr hash_fn get()
+    {
+        return hash;
+    }
+};
+
+template <typename Key> struct hash_adapter<Key, builtin_hash> {
+    static constexpr hash_fn get()
+    {
+        return nullptr;
+    }
+};
+
+#ifdef OHA_WITH_COROUTINES
+// thread local free list of coroutine frames of one size
+class frame_cache
+{
+  public:
+    static void * allocate(size_t size)
+    {
+        state & cache = get();
+        if (size == cache.size && cache.free_list != nullptr) {
+            node * frame = cache.free_list;
+            cache.free_list = frame->next;
+            return frame;
+        }
+        return ::operator new(size < sizeof(node) ? sizeof(node) : size);
+    }
+
+    static void deallocate(void * frame, size_t size) noexcept
+    {
+        state & cache = get();
+        if (cache.size == 0) {
+            cache.size = size;
+        }
+        if (size != cache.size) {
+            ::operator delete(frame);
+            return;
+        }
+        node * free_frame = static_cast<node *>(frame);
+        free_frame->next = cache.free_list;
+        cache.free_list = free_frame;
+    }
+
+  private:
+    struct node {
+        node * next;
+    };
+    struct state {
+        size_t size = 0;
+        node * free_list = nullptr;
+
+        ~state()
+        {
+            while (free_list != nullptr) {
+                node * next = free_list->next;
+                ::operator delete(free_list);
+                free_list = next;
+            }
+        }
+    };
+
+    static state & get() noexcept
+    {
+        static thread_local state cache;
+        return cache;
+    }
+};
+#endif
+
+} // namespace detail
+
+/*
+ * Linear probing hash table with fixed capacity. Hash is a default constructible std::hash-style functor, by default
+ * the built-in hash of the library is used.
+ */
+template <typename Key, typename Value, typename Hash = builtin_hash> class lpht
+{
+    static_assert(std::is_trivially_copyable<Key>::value, "keys are copied and compared bytewise");
+#if __cplusplus >= 201703L
+    static_assert(std::has_unique_object_representations<Key>::value, "keys with padding can not be compared bytewise");
+#endif
+    static_assert(std::is_trivially_copyable<Value>::value, "values are moved bytewise inside the table");
+
+  public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using hasher = Hash;
+    using size_type = oha_capacity_t;
+    static constexpr size_t key_size = sizeof(Key);
+
+    class iterator
+    {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<const Key &, Value &>;
+        using reference = value_type;
+        using pointer = void;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+
+        reference operator*() const
+        {
+            return reference(*static_cast<const Key *>(m_pair.key), *static_cast<Value *>(m_pair.value));
+        }
+
+        iterator & operator++()
+        {
+            m_pair = oha_lpht_get_next_element(m_table, &m_position);
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const iterator & other) const
+        {
+            return m_pair.key == other.m_pair.key;
+        }
+
+        bool operator!=(const iterator & other) const
+        {
+            return !(*this == other);
+        }
+
+      private:
+        friend class lpht;
+
+        explicit iterator(struct oha_lpht * table) : m_table(table)
+        {
+            ++*this;
+        }
+
+        struct oha_lpht * m_table = nullptr;
+        size_t m_position = 0;
+        struct oha_key_value_pair m_pair = {nullptr, nullptr};
+    };
+
+    explicit lpht(size_type max_elems, double load_factor = 0.7, struct oha_memory_fp memory = {nullptr, nullptr, nullptr})
+    {
+        struct oha_lpht_config config = {};
+        config.load_factor = load_factor;
+        config.key_size = key_size;
+        config.value_size = sizeof(Value);
+        config.max_elems = max_elems;
+        config.memory = memory;
+        config.hash_fn = detail::hash_adapter<Key, Hash>::get();
+        m_table = oha_lpht_create(&config);
+        if (m_table == nullptr) {
+            throw std::bad_alloc();
+        }
+    }
+
+    lpht(const lpht &) = delete;
+    lpht & operator=(const lpht &) = delete;
+
+    lpht(lpht && other) noexcept : m_table(other.m_table)
+    {
+        other.m_table = nullptr;
+    }
+
+    lpht & operator=(lpht && other) noexcept
+    {
+        if (this != &other) {
+            oha_lpht_destroy(m_table);
+            m_table = other.m_table;
+            other.m_table = nullptr;
+        }
+        return *this;
+    }
+
+    ~lpht()
+    {
+        oha_lpht_destroy(m_table);
+    }
+
+    Value * find(const Key & key) const noexcept
+    {
+        return static_cast<Value *>(oha_lpht_look_up(m_table, &key));
+    }
+
+    bool contains(const Key & key) const noexcept
+    {
+        return find(key) != nullptr;
+    }
+
+    // looks up count keys with overlapping cache misses, values[i] is nullptr for missing keys
+    void find_batch(const Key * keys, size_t count, Value ** values) const noexcept
+    {
+        oha_lpht_look_up_batch(m_table, keys, count, reinterpret_cast<void **>(values));
+    }
+
+    // inserts the value only if the key is new, returns {nullptr, false} if the table is full
+    std::pair<Value *, bool> insert(const Key & key, const Value & value = Value()) noexcept
+    {
+        bool inserted;
+        void * ptr = oha_lpht_insert_ex(m_table, &key, &inserted);
+        if (ptr == nullptr) {
+            return std::pair<Value *, bool>(nullptr, false);
+        }
+        if (inserted) {
+            return std::pair<Value *, bool>(::new (ptr) Value(value), true);
+        }
+        return std::pair<Value *, bool>(static_cast<Value *>(ptr), false);
+    }
+
+    Value * insert_or_assign(const Key & key, const Value & value) noexcept
+    {
+        bool inserted;
+        void * ptr = oha_lpht_insert_ex(m_table, &key, &inserted);
+        if (ptr == nullptr) {
+            return nullptr;
+        }
+        return ::new (ptr) Value(value);
+    }
+
+    bool erase(const Key & key) noexcept
+    {
+        return oha_lpht_remove(m_table, &key) != nullptr;
+    }
+
+    // pred is called as pred(const Key &, Value &) and returns true for elements to remove
+    template <typename Pred> size_type erase_if(Pred pred)
+    {
+        return oha_lpht_erase_if(
+            m_table,
+            [](const void * key, void * value, void * context) -> bool {
+                return (*static_cast<Pred *>(context))(*static_cast<const Key *>(key), *static_cast<Value *>(value));
+            },
+            &pred);
+    }
+
+    /*
+     * Inserts all elements of src, combine is called as combine(const Key &, Value & dst, const Value & src) for keys
+     * which are already inserted. Returns false if this table got full.
+     */
+    template <typename Combine> bool merge(const lpht & src, Combine combine)
+    {
+        return oha_lpht_merge(
+            m_table,
+            src.m_table,
+            [](const void * key, void * dst_value, const void * src_value, void * context) {
+                (*static_cast<Combine *>(context))(*static_cast<const Key *>(key),
+                                                   *static_cast<Value *>(dst_value),
+                                                   *static_cast<const Value *>(src_value));
+            },
+            &combine);
+    }
+
+    /*
+     * Moves the elements into a table for max_elems with load_factor (0 keeps the load factor). Invalidates all
+     * pointers and iterators into the table. Returns false and keeps the table if the elements do not fit.
+     */
+    bool rehash(size_type max_elems, double load_factor = 0.0) noexcept
+    {
+        struct oha_lpht * table = oha_lpht_rehash(m_table, max_elems, load_factor);
+        if (table == nullptr) {
+            return false;
+        }
+        m_table = table;
+        return true;
+    }
+
+    size_type size() const noexcept
+    {
+        struct oha_lpht_status status;
+        return oha_lpht_get_status(m_table, &status) ? status.elems_in_use : 0;
+    }
+
+    size_type max_size() const noexcept
+    {
+        struct oha_lpht_status status;
+        return oha_lpht_get_status(m_table, &status) ? status.max_elems : 0;
+    }
+
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    iterator begin() const
+    {
+        return iterator(m_table);
+    }
+
+    iterator end() const
+    {
+        return iterator();
+    }
+
+    struct oha_lpht * get() const noexcept
+    {
+        return m_table;
+    }
+
+  private:
+    struct oha_lpht * m_table = nullptr;
+};
+
+#ifdef OHA_WITH_COROUTINES
+/*
+ * Coroutine of one look up, it suspends after every prefetch of a cache line of the probe sequence. The scheduler
+ * resumes many of them round robin, so the memory latency of one look up is hidden by the work of the others.
+ */
+template <typename Value> class find_task
+{
+  public:
+    struct promise_type {
+        Value * result = nullptr;
+
+        find_task get_return_object() noexcept
+        {
+            return find_task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+        std::suspend_always final_suspend() noexcept
+        {
+            return {};
+        }
+        void return_value(Value * value) noexcept
+        {
+            result = value;
+        }
+        void unhandled_exception() noexcept
+        {
+            std::terminate();
+        }
+        // the frames of all look ups have the same size, recycle them to avoid one malloc per look up
+        static void * operator new(size_t size)
+        {
+            return detail::frame_cache::allocate(size);
+        }
+        static void operator delete(void * frame, size_t size) noexcept
+        {
+            detail::frame_cache::deallocate(frame, size);
+        }
+    };
+
+    find_task(find_task && other) noexcept : m_handle(other.m_handle)
+    {
+        other.m_handle = nullptr;
+    }
+    find_task & operator=(find_task && other) noexcept
+    {
+        std::swap(m_handle, other.m_handle);
+        return *this;
+    }
+    ~find_task()
+    {
+        if (m_handle) {
+            m_handle.destroy();
+        }
+    }
+
+    bool done() const noexcept
+    {
+        return m_handle.done();
+    }
+    void resume() const
+    {
+        m_handle.resume();
+    }
+    Value * result() const noexcept
+    {
+        return m_handle.promise().result;
+    }
+
+  private:
+    explicit find_task(std::coroutine_handle<promise_type> handle) : m_handle(handle)
+    {
+    }
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+namespace detail
+{
+
+struct prefetch_awaiter {
+    const void * address;
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+    void await_suspend(std::coroutine_handle<>) const noexcept
+    {
+        __builtin_prefetch(address);
+    }
+    void await_resume() const noexcept
+    {
+    }
+};
+
+} // namespace detail
+
+// walks the probe sequence of the key, the key must stay valid until the task is done
+template <typename Key, typename Value, typename Hash>
+find_task<Value> find_coro(const lpht<Key, Value, Hash> & table, const Key & key)
+{
+    struct oha_lpht_probe probe;
+    co_await detail::prefetch_awaiter{oha_lpht_probe_init(table.get(), &probe, &key)};
+    void * value;
+    while (!oha_lpht_probe_step(table.get(), &probe, &value)) {
+        co_await detail::prefetch_awaiter{probe.bucket};
+    }
+    co_return static_cast<Value *>(value);
+}
+
+namespace detail
+{
+
+// one look up stream of find_interleaved(), the frame lives for all look ups of the stream
+class stream_task
+{
+  public:
+    struct promise_type {
+        stream_task get_return_object() noexcept
+        {
+            return stream_task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+        std::suspend_always final_suspend() noexcept
+        {
+            return {};
+        }
+        void return_void() noexcept
+        {
+        }
+        void unhandled_exception() noexcept
+        {
+            std::terminate();
+        }
+    };
+
+    stream_task(stream_task && other) noexcept : m_handle(other.m_handle)
+    {
+        other.m_handle = nullptr;
+    }
+    stream_task & operator=(stream_task && other) noexcept
+    {
+        std::swap(m_handle, other.m_handle);
+        return *this;
+    }
+    ~stream_task()
+    {
+        if (m_handle) {
+            m_handle.destroy();
+        }
+    }
+
+    bool done() const noexcept
+    {
+        return m_handle.done();
+    }
+    void resume() const
+    {
+        m_handle.resume();
+    }
+
+  private:
+    explicit stream_task(std::coroutine_handle<promise_type> handle) : m_handle(handle)
+    {
+    }
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+// takes the next key of the shared position until all keys are processed
+template <typename Key, typename Value, typename Hash, typename Callback>
+stream_task
+find_stream(const lpht<Key, Value, Hash> & table, const Key * keys, size_t count, size_t & next, Callback & callback)
+{
+    while (next < count) {
+        const size_t index = next++;
+        struct oha_lpht_probe probe;
+        co_await prefetch_awaiter{oha_lpht_probe_init(table.get(), &probe, &keys[index])};
+        void * value;
+        while (!oha_lpht_probe_step(table.get(), &probe, &value)) {
+            co_await prefetch_awaiter{probe.bucket};
+        }
+        // the values are stored apart from the keys, the callback reads them usually
+        if (value != nullptr) {
+            co_await prefetch_awaiter{value};
+        }
+        callback(index, static_cast<Value *>(value));
+    }
+}
+
+} // namespace detail
+
+/*
+ * Runs the look ups of all keys with Interleave coroutines in flight and calls callback(index, Value *) for every
+ * finished look up. Found values are prefetched before the callback. The callbacks are not called in key order.
+ */
+template <size_t Interleave = 16, typename Key, typename Value, typename Hash, typename Callback>
+void find_interleaved(const lpht<Key, Value, Hash> & table, const Key * keys, size_t count, Callback && callback)
+{
+    static_assert(Interleave > 0, "at least one look up must be in flight");
+    size_t next = 0;
+    std::vector<detail::stream_task> streams;
+    streams.reserve(Interleave);
+    for (size_t i = 0; i < Interleave && i < count; i++) {
+        streams.push_back(detail::find_stream(table, keys, count, next, callback));
+    }
+    // round robin until all streams are done, finished streams are removed by the last stream
+    while (!streams.empty()) {
+        for (size_t i = 0; i < streams.size();) {
+            streams[i].resume();
+            if (streams[i].done()) {
+                std::swap(streams[i], streams.back());
+                streams.pop_back();
+            } else {
+                i++;
+            }
+        }
+    }
+}
+#endif
+
+} // namespace oha
+
+#endif
@@ -0,0 +1,162 @@
+#include "oha.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+
+#define DEFAULT_BLOCK_SIZE (1024 * 1024)
+#define MIN_SIZE_CLASS 6 // 64 bytes
+#define NUM_SIZE_CLASSES (SIZE_T_WIDTH * 8)
+#define CHUNK_ALIGNMENT 16
+
+struct arena_block {
+    struct arena_block * next;
+    size_t size; // usable bytes in data
+    size_t used;
+    // keep the chunks 16 byte aligned
+    _Alignas(CHUNK_ALIGNMENT) uint8_t data[];
+};
+
+struct chunk_header {
+    union {
+        struct chunk_header * next_free; // only valid if the chunk is in a free list
+        size_t size_class;
+    };
+    uint8_t padding[CHUNK_ALIGNMENT - sizeof(void *)];
+};
+
+struct oha_arena {
+    size_t block_size;
+    struct arena_block * blocks;
+    struct chunk_header * free_lists[NUM_SIZE_CLASSES];
+};
+
+static size_t get_size_class(size_t size)
+{
+    size_t size_class = MIN_SIZE_CLASS;
+    while (((size_t)1 << size_class) < size) {
+        size_class++;
+    }
+    return size_class;
+}
+
+static struct arena_block * add_block(struct oha_arena * arena, size_t min_size)
+{
+    size_t size = MAX(arena->block_size, min_size);
+    struct arena_block * block = malloc(sizeof(struct arena_block) + size);
+    if (block == NULL) {
+        return NULL;
+    }
+    block->size = size;
+    block->used = 0;
+    block->next = arena->blocks;
+    arena->blocks = block;
+    return block;
+}
+
+static void release_blocks(struct arena_block * block)
+{
+    while (block != NULL) {
+        struct arena_block * next = block->next;
+        free(block);
+        block = next;
+    }
+}
+
+/*
+ * public functions
+ */
+
+struct oha_arena * oha_arena_create(size_t block_size)
+{
+    struct oha_arena * arena = calloc(1, sizeof(struct oha_arena));
+    if (arena == NULL) {
+        return NULL;
+    }
+    arena->block_size = block_size == 0 ? DEFAULT_BLOCK_SIZE : block_size;
+    return arena;
+}
+
+void oha_arena_destroy(struct oha_arena * arena)
+{
+    if (arena == NULL) {
+        return;
+    }
+    release_blocks(arena->blocks);
+    free(arena);
+}
+
+void oha_arena_reset(struct oha_arena * arena)
+{
+    if (arena == NULL) {
+        return;
+    }
+    // keep the newest block to avoid a malloc for the next allocations
+    if (arena->blocks != NULL) {
+        release_blocks(arena->blocks->next);
+        arena->blocks->next = NULL;
+        arena->blocks->used = 0;
+    }
+    memset(arena->free_lists, 0, sizeof(arena->free_lists));
+}
+
+void * oha_arena_alloc(size_t size, void * context)
+{
+    struct oha_arena * arena = context;
+    if (arena == NULL || size == 0) {
+        return NULL;
+    }
+
+    size_t size_class = get_size_class(size);
+    if (size_class >= NUM_SIZE_CLASSES) {
+        return NULL;
+    }
+
+    // reuse a freed chunk of the same size class
+    struct chunk_header * chunk = arena->free_lists[size_class];
+    if (chunk != NULL) {
+        arena->free_lists[size_class] = chunk->next_free;
+        chunk->size_class = size_class;
+        return chunk + 1;
+    }
+
+    size_t chunk_size = sizeof(struct chunk_header) + ((size_t)1 << size_class);
+    struct arena_block * block = arena->blocks;
+    if (block == NULL || block->size - block->used < chunk_size) {
+        block = add_block(arena, chunk_size);
+        if (block == NULL) {
+            return NULL;
+        }
+    }
+
+    chunk = (struct chunk_header *)&block->data[block->used];
+    block->used += chunk_size;
+    chunk->size_class = size_class;
+    return chunk + 1;
+}
+
+void oha_arena_free(void * ptr, void * context)
+{
+    struct oha_arena * arena = context;
+    if (arena == NULL || ptr == NULL) {
+        return;
+    }
+    struct chunk_header * chunk = (struct chunk_header *)ptr - 1;
+    size_t size_class = chunk->size_class;
+    assert(size_class < NUM_SIZE_CLASSES);
+    chunk->next_free = arena->free_lists[size_class];
+    arena->free_lists[size_class] = chunk;
+}
+
+struct oha_memory_fp oha_arena_get_memory_fp(struct oha_arena * arena)
+{
+    struct oha_memory_fp memory = {
+        .alloc = oha_arena_alloc,
+        .free = oha_arena_free,
+        .context = arena,
+    };
+    return memory;
+}
@@ -0,0 +1,144 @@
+#include "batch_hash.h"
+
+#include <stdbool.h>
+
+#include <xxhash.h>
+
+#ifdef OHA_WITH_BATCH_HASH
+#include <immintrin.h>
+#endif
+
+/*
+ * XXH64 of inputs with 4 or 8 bytes is a fixed sequence of 64 bit multiplies, rotates and xor shifts, see
+ * XXH64_finalize() and XXH64_avalanche(). The vector kernels run this sequence on 4 or 8 keys per instruction.
+ */
+#define PRIME64_1 0x9E3779B185EBCA87ULL
+#define PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define PRIME64_3 0x165667B19E3779F9ULL
+#define PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define PRIME64_5 0x27D4EB2F165667C5ULL
+
+typedef void (*hash_batch_fn)(const void * keys, size_t key_size, size_t count, uint64_t seed, uint64_t * hashes);
+
+void oha_xxh64_batch_scalar(const void * keys, size_t key_size, size_t count, uint64_t seed, uint64_t * hashes)
+{
+    const uint8_t * key = keys;
+    for (size_t i = 0; i < count; i++) {
+        hashes[i] = XXH64(key + i * key_size, key_size, seed);
+    }
+}
+
+#ifdef OHA_WITH_BATCH_HASH
+
+#define AVX2 __attribute__((target("avx2")))
+#define AVX512 __attribute__((target("avx512f,avx512dq")))
+
+// AVX2 has no 64 bit multiply, it is composed of three 32 bit multiplies
+AVX2 static inline __m256i mul64_avx2(__m256i a, uint64_t b)
+{
+    const __m256i vb = _mm256_set1_epi64x(b);
+    const __m256i lo = _mm256_mul_epu32(a, vb);
+    const __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), vb),
+                                           _mm256_mul_epu32(a, _mm256_srli_epi64(vb, 32)));
+    return _mm256_add_epi64(lo, _mm256_slli_epi64(cross, 32));
+}
+
+AVX2 static inline __m256i rotl64_avx2(__m256i a, int bits)
+{
+    return _mm256_or_si256(_mm256_slli_epi64(a, bits), _mm256_srli_epi64(a, 64 - bits));
+}
+
+AVX2 static inline __m256i xor_shift_avx2(__m256i a, int bits)
+{
+    return _mm256_xor_si256(a, _mm256_srli_epi64(a, bits));
+}
+
+AVX2 void oha_xxh64_batch_avx2(const void * keys, size_t key_size, size_t count, uint64_t seed, uint64_t * hashes)
+{
+    const uint8_t * key = keys;
+    const __m256i start = _mm256_set1_epi64x(seed + PRIME64_5 + key_size);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i h = start;
+        if (key_size == 8) {
+            __m256i k = _mm256_loadu_si256((const __m256i *)(key + i * 8));
+            k = mul64_avx2(rotl64_avx2(mul64_avx2(k, PRIME64_2), 31), PRIME64_1);
+            h = _mm256_xor_si256(h, k);
+            h = _mm256_add_epi64(mul64_avx2(rotl64_avx2(h, 27), PRIME64_1), _mm256_set1_epi64x(PRIME64_4));
+        } else {
+            __m256i k = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i *)(key + i * 4)));
+            h = _mm256_xor_si256(h, mul64_avx2(k, PRIME64_1));
+            h = _mm256_add_epi64(mul64_avx2(rotl64_avx2(h, 23), PRIME64_2), _mm256_set1_epi64x(PRIME64_3));
+        }
+        h = mul64_avx2(xor_shift_avx2(h, 33), PRIME64_2);
+        h = mul64_avx2(xor_shift_avx2(h, 29), PRIME64_3);
+        h = xor_shift_avx2(h, 32);
+        _mm256_storeu_si256((__m256i *)(hashes + i), h);
+    }
+    oha_xxh64_batch_scalar(key + i * key_size, key_size, count - i, seed, hashes + i);
+}
+
+AVX512 static inline __m512i mul64_avx512(__m512i a, uint64_t b)
+{
+    return _mm512_mullo_epi64(a, _mm512_set1_epi64(b));
+}
+
+AVX512 static inline __m512i xor_shift_avx512(__m512i a, int bits)
+{
+    return _mm512_xor_si512(a, _mm512_srli_epi64(a, bits));
+}
+
+AVX512 void oha_xxh64_batch_avx512(const void * keys, size_t key_size, size_t count, uint64_t seed, uint64_t * hashes)
+{
+    const uint8_t * key = keys;
+    const __m512i start = _mm512_set1_epi64(seed + PRIME64_5 + key_size);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m512i h = start;
+        if (key_size == 8) {
+            __m512i k = _mm512_loadu_si512((const void *)(key + i * 8));
+            k = mul64_avx512(_mm512_rol_epi64(mul64_avx512(k, PRIME64_2), 31), PRIME64_1);
+            h = _mm512_xor_si512(h, k);
+            h = _mm512_add_epi64(mul64_avx512(_mm512_rol_epi64(h, 27), PRIME64_1), _mm512_set1_epi64(PRIME64_4));
+        } else {
+            __m512i k = _mm512_cvtepu32_epi64(_mm256_loadu_si256((const __m256i *)(key + i * 4)));
+            h = _mm512_xor_si512(h, mul64_avx512(k, PRIME64_1));
+            h = _mm512_add_epi64(mul64_avx512(_mm512_rol_epi64(h, 23), PRIME64_2), _mm512_set1_epi64(PRIME64_3));
+        }
+        h = mul64_avx512(xor_shift_avx512(h, 33), PRIME64_2);
+        h = mul64_avx512(xor_shift_avx512(h, 29), PRIME64_3);
+        h = xor_shift_avx512(h, 32);
+        _mm512_storeu_si512((void *)(hashes + i), h);
+    }
+    oha_xxh64_batch_scalar(key + i * key_size, key_size, count - i, seed, hashes + i);
+}
+
+static hash_batch_fn select_kernel(void)
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) {
+        return oha_xxh64_batch_avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return oha_xxh64_batch_avx2;
+    }
+    return oha_xxh64_batch_scalar;
+}
+
+#endif
+
+void oha_xxh64_batch(const void * keys, size_t key_size, size_t count, uint64_t seed, uint64_t * hashes)
+{
+#ifdef OHA_WITH_BATCH_HASH
+    // selected on the first call, concurrent first calls select the same kernel
+    static hash_batch_fn kernel = NULL;
+    hash_batch_fn fn = __atomic_load_n(&kernel, __ATOMIC_RELAXED);
+    if (fn == NULL) {
+        fn = select_kernel();
+        __atomic_store_n(&kernel, fn, __ATOMIC_RELAXED);
+    }
+    fn(keys, key_size, count, seed, hashes);
+#else
+    oha_xxh64_batch_scalar(keys, key_size, count, seed, hashes);
+#endif
+}
@@ -0,0 +1,25 @@
+#ifndef OHA_BATCH_HASH_H_
+#define OHA_BATCH_HASH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// SIMD kernels are built for x86-64 only, they are selected at runtime by the CPU features
+#if defined(__x86_64__) && defined(__GNUC__)
+#define OHA_WITH_BATCH_HASH
+#endif
+
+/*
+ * Hashes count keys of 4 or 8 bytes, stored contiguous, bit identical to XXH64(key, key_size, seed). Uses the widest
+ * vector unit of the CPU.
+ */
+void oha_xxh64_batch(const void * keys, size_t key_size, size_t count, uint64_t seed, uint64_t * hashes);
+
+// the single kernels, e.g. to test them, the vector kernels must only be called if the CPU supports them
+void oha_xxh64_batch_scalar(const void * keys, size_t key_size, size_t count, uint64_t seed, uint64_t * hashes);
+#ifdef OHA_WITH_BATCH_HASH
+void oha_xxh64_batch_avx2(const void * keys, size_t key_size, size_t count, uint64_t seed, uint64_t * hashes);
+void oha_xxh64_batch_avx512(const void * keys, size_t key_size, size_t count, uint64_t seed, uint64_t * hashes);
+#endif
+
+#endif
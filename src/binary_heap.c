@@ -20,24 +20,25 @@ struct key_bucket {
 };
 
 struct oha_bh {
+    struct oha_memory_fp memory;
     size_t value_size;
-    uint_fast32_t max_elems;
-    uint_fast32_t elems;
+    oha_capacity_t max_elems;
+    oha_capacity_t elems;
     struct value_bucket * values;
     struct key_bucket * keys;
 };
 
-static inline uint_fast32_t parent(uint_fast32_t i)
+static inline size_t parent(size_t i)
 {
     return (i - 1) / 2;
 }
 
-static inline uint_fast32_t left(uint_fast32_t i)
+static inline size_t left(size_t i)
 {
     return (2 * i + 1);
 }
 
-static inline uint_fast32_t right(uint_fast32_t i)
+static inline size_t right(size_t i)
 {
     return (2 * i + 2);
 }
@@ -51,11 +52,11 @@ static inline void swap_keys(struct key_bucket * restrict a, struct key_bucket *
     *b = tmp_a;
 }
 
-static void heapify(struct oha_bh * heap, uint_fast32_t i)
+static void heapify(struct oha_bh * heap, size_t i)
 {
-    uint_fast32_t l = left(i);
-    uint_fast32_t r = right(i);
-    uint_fast32_t smallest = i;
+    size_t l = left(i);
+    size_t r = right(i);
+    size_t smallest = i;
     if (l < heap->elems && heap->keys[l].key < heap->keys[i].key)
         smallest = l;
     if (r < heap->elems && heap->keys[r].key < heap->keys[smallest].key)
@@ -66,40 +67,37 @@ static void heapify(struct oha_bh * heap, uint_fast32_t i)
     }
 }
 
-void oha_bh_destroy(struct oha_bh * heap)
-{
-    free(heap->keys);
-    free(heap->values);
-    free(heap);
-}
-
-struct oha_bh * oha_bh_create(const struct oha_bh_config * config)
+static int get_storage_values(const struct oha_bh_config * config, size_t * value_size, size_t * heap_size)
 {
     if (config == NULL) {
-        return NULL;
+        return -1;
     }
-    struct oha_bh * heap = calloc(1, sizeof(struct oha_bh));
-    if (heap == NULL) {
-        return NULL;
-    }
-
-    heap->keys = calloc(config->max_elems, sizeof(struct key_bucket));
-    if (heap->keys == NULL) {
-        oha_bh_destroy(heap);
-        return NULL;
+    *value_size = add_alignment(sizeof(struct value_bucket) + config->value_size);
+
+    // heap space + keys + values
+    size_t keys_size;
+    size_t values_size;
+    *heap_size = add_alignment(sizeof(struct oha_bh));
+    if (!oha_mul_size(sizeof(struct key_bucket), config->max_elems, &keys_size) ||
+        !oha_mul_size(*value_size, config->max_elems, &values_size) || !oha_add_size(*heap_size, keys_size, heap_size) ||
+        !oha_add_size(*heap_size, values_size, heap_size)) {
+        return -1;
     }
+    return 0;
+}
 
-    heap->value_size = sizeof(struct value_bucket) + config->value_size;
-    heap->values = calloc(config->max_elems, heap->value_size);
-    if (heap->values == NULL) {
-        oha_bh_destroy(heap);
-        return NULL;
-    }
+static struct oha_bh * init_heap_value(const struct oha_bh_config * config, size_t value_size, struct oha_bh * heap)
+{
+    heap->memory = config->memory;
+    heap->value_size = value_size;
     heap->max_elems = config->max_elems;
+    heap->elems = 0;
+    heap->keys = move_ptr_num_bytes(heap, add_alignment(sizeof(struct oha_bh)));
+    heap->values = move_ptr_num_bytes(heap->keys, sizeof(struct key_bucket) * heap->max_elems);
 
     // connect keys and values
     struct value_bucket * tmp_value = heap->values;
-    for (uint_fast32_t i = 0; i < heap->max_elems; i++) {
+    for (size_t i = 0; i < heap->max_elems; i++) {
         heap->keys[i].value = tmp_value;
         tmp_value->key = &heap->keys[i];
         tmp_value = move_ptr_num_bytes(tmp_value, heap->value_size);
@@ -108,6 +106,50 @@ struct oha_bh * oha_bh_create(const struct oha_bh_config * config)
     return heap;
 }
 
+void oha_bh_destroy(struct oha_bh * heap)
+{
+    if (heap == NULL) {
+        return;
+    }
+    struct oha_memory_fp memory = heap->memory;
+    oha_free(&memory, heap);
+}
+
+size_t oha_bh_calculate_size(const struct oha_bh_config * config)
+{
+    size_t value_size;
+    size_t heap_size;
+    if (get_storage_values(config, &value_size, &heap_size) != 0) {
+        return 0;
+    }
+    return heap_size;
+}
+
+struct oha_bh * oha_bh_initialize(const struct oha_bh_config * config, void * memory)
+{
+    size_t value_size;
+    size_t heap_size;
+    if (memory == NULL || get_storage_values(config, &value_size, &heap_size) != 0) {
+        return NULL;
+    }
+    return init_heap_value(config, value_size, memory);
+}
+
+struct oha_bh * oha_bh_create(const struct oha_bh_config * config)
+{
+    size_t value_size;
+    size_t heap_size;
+    if (get_storage_values(config, &value_size, &heap_size) != 0) {
+        return NULL;
+    }
+    // keys and values are placed behind the heap structure in one allocation
+    struct oha_bh * heap = oha_calloc(&config->memory, heap_size);
+    if (heap == NULL) {
+        return NULL;
+    }
+    return init_heap_value(config, value_size, heap);
+}
+
 void * oha_bh_insert(struct oha_bh * heap, int64_t key)
 {
     if (heap == NULL) {
@@ -118,7 +160,7 @@ void * oha_bh_insert(struct oha_bh * heap, int64_t key)
     }
 
     // insert the new key at the end
-    uint_fast32_t i = heap->elems;
+    size_t i = heap->elems;
     heap->keys[i].key = key;
 
     // Fix the min heap property if it is violated
@@ -185,7 +227,7 @@ int64_t oha_bh_change_key(struct oha_bh * heap, void * value, int64_t new_val)
     }
 
     key->key = new_val;
-    uint_fast32_t index = key - heap->keys;
+    size_t index = key - heap->keys;
 
     switch (mode) {
         case UNCHANGED_KEY:
@@ -0,0 +1,404 @@
+#include "oha.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <xxhash.h>
+
+#include "utils.h"
+
+#define XXHASH_SEED 0xc800c831bc63dff8
+#define SLOTS_PER_BUCKET 4
+// maximum number of slots visited by the displacement path search, an insert fails if no free slot is found
+#define MAX_SEARCH_SLOTS 2048
+#define EMPTY_TAG 0
+
+struct slot {
+    uint32_t tag;         // upper hash bits, EMPTY_TAG marks a free slot
+    uint32_t value_index; // index of the value, moves together with the key
+    uint8_t key_buffer[];
+};
+
+struct bfs_entry {
+    uint32_t bucket;
+    uint16_t slot;
+    int16_t parent; // index of the previous path entry in the search queue, -1 for the buckets of the new key
+};
+
+struct oha_ccht {
+    struct oha_memory_fp memory;
+    uint64_t (*hash_fn)(const void * key, size_t key_size);
+    uint8_t * buckets;
+    uint8_t * values;
+    size_t key_size;
+    size_t slot_size;
+    size_t bucket_size;
+    size_t value_size;
+    uint_fast32_t num_buckets;
+    uint_fast32_t elems;
+    uint_fast32_t max_elems;
+};
+
+struct storage_info {
+    size_t key_size;
+    size_t slot_size;
+    size_t bucket_size;
+    size_t value_size;
+    uint_fast32_t num_buckets;
+    size_t table_size;
+};
+
+static int get_storage_values(const struct oha_lpht_config * config, struct storage_info * values)
+{
+    if (config == NULL || values == NULL) {
+        return EINVAL;
+    }
+    if (config->max_elems == 0 || config->value_size == 0 || config->key_size == 0 || config->load_factor <= 0.0 ||
+        config->load_factor >= 1.0) {
+        return EINVAL;
+    }
+    if (has_lpht_only_options(config)) {
+        return EINVAL;
+    }
+
+    // slots are addressed with 32 bit value indices
+    double num_buckets = ceil((1 / config->load_factor) * config->max_elems / SLOTS_PER_BUCKET);
+    if (num_buckets * SLOTS_PER_BUCKET > UINT32_MAX) {
+        return EINVAL;
+    }
+
+    values->key_size = config->key_size;
+    values->slot_size = add_alignment(sizeof(struct slot) + config->key_size);
+    values->bucket_size = values->slot_size * SLOTS_PER_BUCKET;
+    // small buckets fill exactly one cache line
+    if (values->bucket_size <= CACHE_LINE_SIZE) {
+        values->bucket_size = CACHE_LINE_SIZE;
+    }
+    values->value_size = add_alignment(config->value_size);
+    values->num_buckets = num_buckets;
+    values->table_size = sizeof(struct oha_ccht) + CACHE_LINE_SIZE                       // table space + alignment
+                         + values->bucket_size * values->num_buckets                    // keys
+                         + values->value_size * values->num_buckets * SLOTS_PER_BUCKET; // values
+    return 0;
+}
+
+static struct oha_ccht * init_table_value(const struct oha_lpht_config * config,
+                                          const struct storage_info * storage,
+                                          struct oha_ccht * table)
+{
+    table->memory = config->memory;
+    table->hash_fn = config->hash_fn;
+    table->key_size = storage->key_size;
+    table->slot_size = storage->slot_size;
+    table->bucket_size = storage->bucket_size;
+    table->value_size = storage->value_size;
+    table->num_buckets = storage->num_buckets;
+    table->elems = 0;
+    table->max_elems = config->max_elems;
+
+    table->buckets = align_ptr_cache_line(move_ptr_num_bytes(table, sizeof(struct oha_ccht)));
+    table->values = move_ptr_num_bytes(table->buckets, table->bucket_size * storage->num_buckets);
+
+    // connect slots and values
+    uint32_t value_index = 0;
+    for (uint_fast32_t b = 0; b < storage->num_buckets; b++) {
+        for (uint_fast32_t s = 0; s < SLOTS_PER_BUCKET; s++) {
+            struct slot * slot =
+                move_ptr_num_bytes(table->buckets, table->bucket_size * b + table->slot_size * s);
+            slot->tag = EMPTY_TAG;
+            slot->value_index = value_index++;
+        }
+    }
+    return table;
+}
+
+static uint64_t hash_key(struct oha_ccht * table, const void * key)
+{
+    if (table->hash_fn != NULL) {
+        return table->hash_fn(key, table->key_size);
+    }
+    return XXH64(key, table->key_size, XXHASH_SEED);
+}
+
+static inline uint32_t get_tag(uint64_t hash)
+{
+    return (uint32_t)(hash >> 32) | 1;
+}
+
+/*
+ * The alternative bucket only depends on the tag, so a key can be moved without hashing it again. The mapping is an
+ * involution for every number of buckets: alt(alt(bucket)) == bucket.
+ */
+static inline uint_fast32_t get_alt_bucket(struct oha_ccht * table, uint_fast32_t bucket, uint32_t tag)
+{
+    uint_fast32_t shift = (tag * 0x5bd1e995ULL) % table->num_buckets;
+    return (shift + table->num_buckets - bucket) % table->num_buckets;
+}
+
+static inline struct slot * get_slot(struct oha_ccht * table, uint_fast32_t bucket, uint_fast32_t slot)
+{
+    return move_ptr_num_bytes(table->buckets, table->bucket_size * bucket + table->slot_size * slot);
+}
+
+static inline void * get_value(struct oha_ccht * table, struct slot * slot)
+{
+    return move_ptr_num_bytes(table->values, table->value_size * slot->value_index);
+}
+
+static struct slot * find_in_bucket(struct oha_ccht * table, uint_fast32_t bucket, uint32_t tag, const void * key)
+{
+    for (uint_fast32_t s = 0; s < SLOTS_PER_BUCKET; s++) {
+        struct slot * slot = get_slot(table, bucket, s);
+        if (slot->tag == tag && memcmp(slot->key_buffer, key, table->key_size) == 0) {
+            return slot;
+        }
+    }
+    return NULL;
+}
+
+static struct slot * find_slot(struct oha_ccht * table, const void * key)
+{
+    uint64_t hash = hash_key(table, key);
+    uint32_t tag = get_tag(hash);
+    uint_fast32_t bucket = hash % table->num_buckets;
+    struct slot * slot = find_in_bucket(table, bucket, tag, key);
+    if (slot != NULL) {
+        return slot;
+    }
+    return find_in_bucket(table, get_alt_bucket(table, bucket, tag), tag, key);
+}
+
+static int find_free_slot(struct oha_ccht * table, uint_fast32_t bucket)
+{
+    for (uint_fast32_t s = 0; s < SLOTS_PER_BUCKET; s++) {
+        if (get_slot(table, bucket, s)->tag == EMPTY_TAG) {
+            return s;
+        }
+    }
+    return -1;
+}
+
+static void move_slot(struct oha_ccht * table, struct slot * restrict dest, struct slot * restrict src)
+{
+    assert(dest->tag == EMPTY_TAG);
+    uint32_t tmp = dest->value_index;
+    dest->value_index = src->value_index;
+    src->value_index = tmp;
+    dest->tag = src->tag;
+    memcpy(dest->key_buffer, src->key_buffer, table->key_size);
+    src->tag = EMPTY_TAG;
+}
+
+static bool is_on_path(const struct bfs_entry * queue, int_fast32_t index, uint_fast32_t bucket, uint_fast32_t slot)
+{
+    for (; index >= 0; index = queue[index].parent) {
+        if (queue[index].bucket == bucket && queue[index].slot == slot) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Searches the shortest displacement path with a breadth first search starting at both buckets of the new key and
+ * moves all keys of the path to their alternative buckets. Returns the freed slot or NULL if no path was found.
+ */
+static struct slot * make_room(struct oha_ccht * table, uint_fast32_t bucket, uint_fast32_t alt_bucket)
+{
+    struct bfs_entry queue[MAX_SEARCH_SLOTS];
+    int_fast32_t tail = 0;
+    for (uint_fast32_t s = 0; s < SLOTS_PER_BUCKET; s++) {
+        queue[tail++] = (struct bfs_entry){.bucket = bucket, .slot = s, .parent = -1};
+        if (alt_bucket != bucket) {
+            queue[tail++] = (struct bfs_entry){.bucket = alt_bucket, .slot = s, .parent = -1};
+        }
+    }
+
+    for (int_fast32_t head = 0; head < tail; head++) {
+        struct slot * victim = get_slot(table, queue[head].bucket, queue[head].slot);
+        uint_fast32_t victim_alt_bucket = get_alt_bucket(table, queue[head].bucket, victim->tag);
+        int free_slot = find_free_slot(table, victim_alt_bucket);
+        if (free_slot >= 0) {
+            // move backwards along the path, every move frees the slot for the previous one
+            struct slot * dest = get_slot(table, victim_alt_bucket, free_slot);
+            for (int_fast32_t i = head; i >= 0; i = queue[i].parent) {
+                struct slot * src = get_slot(table, queue[i].bucket, queue[i].slot);
+                move_slot(table, dest, src);
+                dest = src;
+            }
+            return dest;
+        }
+        if (tail + SLOTS_PER_BUCKET > MAX_SEARCH_SLOTS) {
+            continue;
+        }
+        for (uint_fast32_t s = 0; s < SLOTS_PER_BUCKET; s++) {
+            if (!is_on_path(queue, head, victim_alt_bucket, s)) {
+                queue[tail++] = (struct bfs_entry){.bucket = victim_alt_bucket, .slot = s, .parent = head};
+            }
+        }
+    }
+    return NULL;
+}
+
+/*
+ * public functions
+ */
+
+size_t oha_ccht_calculate_size(const struct oha_lpht_config * config)
+{
+    struct storage_info storage;
+    if (get_storage_values(config, &storage) != 0) {
+        return 0;
+    }
+    return storage.table_size;
+}
+
+struct oha_ccht * oha_ccht_initialize(const struct oha_lpht_config * config, void * memory)
+{
+    struct oha_ccht * table = memory;
+    if (table == NULL) {
+        return NULL;
+    }
+    struct storage_info storage;
+    if (get_storage_values(config, &storage) != 0) {
+        return NULL;
+    }
+    return init_table_value(config, &storage, table);
+}
+
+struct oha_ccht * oha_ccht_create(const struct oha_lpht_config * config)
+{
+    struct storage_info storage;
+    if (get_storage_values(config, &storage) != 0) {
+        return NULL;
+    }
+    struct oha_ccht * table = oha_calloc(&config->memory, storage.table_size);
+    if (table == NULL) {
+        return NULL;
+    }
+    return init_table_value(config, &storage, table);
+}
+
+void oha_ccht_destroy(struct oha_ccht * table)
+{
+    if (table == NULL) {
+        return;
+    }
+    struct oha_memory_fp memory = table->memory;
+    oha_free(&memory, table);
+}
+
+// return pointer to value
+void * oha_ccht_look_up(struct oha_ccht * table, const void * key)
+{
+    if (table == NULL || key == NULL) {
+        return NULL;
+    }
+    struct slot * slot = find_slot(table, key);
+    return slot != NULL ? get_value(table, slot) : NULL;
+}
+
+// return pointer to value, inserted is set to true if the key was not in the table before
+void * oha_ccht_insert_ex(struct oha_ccht * table, const void * key, bool * inserted)
+{
+    if (inserted != NULL) {
+        *inserted = false;
+    }
+    if (table == NULL || key == NULL || inserted == NULL) {
+        return NULL;
+    }
+
+    uint64_t hash = hash_key(table, key);
+    uint32_t tag = get_tag(hash);
+    uint_fast32_t bucket = hash % table->num_buckets;
+    uint_fast32_t alt_bucket = get_alt_bucket(table, bucket, tag);
+
+    struct slot * slot = find_in_bucket(table, bucket, tag, key);
+    if (slot == NULL) {
+        slot = find_in_bucket(table, alt_bucket, tag, key);
+    }
+    if (slot != NULL) {
+        // already inserted
+        return get_value(table, slot);
+    }
+    if (table->elems >= table->max_elems) {
+        return NULL;
+    }
+
+    int free_slot = find_free_slot(table, bucket);
+    if (free_slot >= 0) {
+        slot = get_slot(table, bucket, free_slot);
+    } else if ((free_slot = find_free_slot(table, alt_bucket)) >= 0) {
+        slot = get_slot(table, alt_bucket, free_slot);
+    } else {
+        slot = make_room(table, bucket, alt_bucket);
+        if (slot == NULL) {
+            return NULL;
+        }
+    }
+
+    slot->tag = tag;
+    memcpy(slot->key_buffer, key, table->key_size);
+    table->elems++;
+    *inserted = true;
+    return get_value(table, slot);
+}
+
+// return pointer to value
+void * oha_ccht_insert(struct oha_ccht * table, const void * key)
+{
+    bool inserted;
+    return oha_ccht_insert_ex(table, key, &inserted);
+}
+
+// return pointer to the removed value, the value is valid until the next insert
+void * oha_ccht_remove(struct oha_ccht * table, const void * key)
+{
+    if (table == NULL || key == NULL) {
+        return NULL;
+    }
+    struct slot * slot = find_slot(table, key);
+    if (slot == NULL) {
+        return NULL;
+    }
+    slot->tag = EMPTY_TAG;
+    table->elems--;
+    return get_value(table, slot);
+}
+
+struct oha_key_value_pair oha_ccht_get_next_element(struct oha_ccht * table, size_t * position)
+{
+    struct oha_key_value_pair pair = {0};
+    if (table == NULL || position == NULL) {
+        return pair;
+    }
+    size_t max_slots = (size_t)table->num_buckets * SLOTS_PER_BUCKET;
+    while (*position < max_slots) {
+        struct slot * slot = get_slot(table, *position / SLOTS_PER_BUCKET, *position % SLOTS_PER_BUCKET);
+        (*position)++;
+        if (slot->tag != EMPTY_TAG) {
+            pair.key = slot->key_buffer;
+            pair.value = get_value(table, slot);
+            break;
+        }
+    }
+    return pair;
+}
+
+bool oha_ccht_get_status(struct oha_ccht * table, struct oha_lpht_status * status)
+{
+    if (table == NULL || status == NULL) {
+        return false;
+    }
+    memset(status, 0, sizeof(*status));
+    size_t num_buckets = table->num_buckets;
+    status->max_elems = table->max_elems;
+    status->elems_in_use = table->elems;
+    status->size_in_bytes = sizeof(struct oha_ccht) + CACHE_LINE_SIZE + table->bucket_size * num_buckets +
+                            table->value_size * num_buckets * SLOTS_PER_BUCKET;
+    return true;
+}
@@ -0,0 +1,169 @@
+#include "oha.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+
+#define PROBE_BLOCK_SIZE 64 // probe keys per batch look up
+
+/*
+ * The chain entries and the lpht values are build indices + 1, so 0 marks the end of a chain. The chains are build
+ * in reverse order and list the build indices ascending.
+ */
+struct oha_hj {
+    struct oha_memory_fp memory;
+    struct oha_lpht * table; // key -> first entry of the chain
+    size_t key_size;
+    size_t build_count;
+    oha_capacity_t chain[]; // next entry per build index
+};
+
+static inline size_t to_build_idx(oha_capacity_t entry)
+{
+    return entry == 0 ? OHA_HJ_END : (size_t)entry - 1;
+}
+
+// writes the matches of the chain until the output is full, returns the first entry which did not fit or 0
+static oha_capacity_t write_matches(struct oha_hj * join,
+                                    oha_capacity_t entry,
+                                    size_t probe_idx,
+                                    struct oha_hj_match * matches,
+                                    size_t * n,
+                                    size_t max_matches)
+{
+    while (entry != 0 && *n < max_matches) {
+        matches[*n].build_idx = entry - 1;
+        matches[*n].probe_idx = probe_idx;
+        (*n)++;
+        entry = join->chain[entry - 1];
+    }
+    return entry;
+}
+
+/*
+ * public functions
+ */
+
+struct oha_hj * oha_hj_create(const struct oha_hj_config * config, const void * build_keys, size_t build_count)
+{
+    if (config == NULL || (build_keys == NULL && build_count > 0)) {
+        return NULL;
+    }
+    // the entries are stored as index + 1
+    if ((uint64_t)build_count >= (oha_capacity_t)-1) {
+        return NULL;
+    }
+
+    size_t size;
+    if (!oha_mul_size(sizeof(oha_capacity_t), build_count, &size) ||
+        !oha_add_size(size, sizeof(struct oha_hj), &size)) {
+        return NULL;
+    }
+    struct oha_hj * join = oha_calloc(&config->memory, size);
+    if (join == NULL) {
+        return NULL;
+    }
+    join->memory = config->memory;
+    join->key_size = config->key_size;
+    join->build_count = build_count;
+
+    const struct oha_lpht_config table_config = {
+        .load_factor = config->load_factor,
+        .key_size = config->key_size,
+        .value_size = sizeof(oha_capacity_t),
+        .max_elems = MAX(build_count, 1),
+        .memory = config->memory,
+        .hash_fn = config->hash_fn,
+    };
+    join->table = oha_lpht_create(&table_config);
+    if (join->table == NULL) {
+        oha_hj_destroy(join);
+        return NULL;
+    }
+
+    for (size_t i = build_count; i > 0; i--) {
+        const void * key = (const uint8_t *)build_keys + (i - 1) * config->key_size;
+        bool inserted;
+        oha_capacity_t * first = oha_lpht_insert_ex(join->table, key, &inserted);
+        join->chain[i - 1] = inserted ? 0 : *first;
+        *first = i;
+    }
+    return join;
+}
+
+void oha_hj_destroy(struct oha_hj * join)
+{
+    if (join == NULL) {
+        return;
+    }
+    oha_lpht_destroy(join->table);
+    struct oha_memory_fp memory = join->memory;
+    oha_free(&memory, join);
+}
+
+size_t oha_hj_find(struct oha_hj * join, const void * key)
+{
+    if (join == NULL || key == NULL) {
+        return OHA_HJ_END;
+    }
+    const oha_capacity_t * first = oha_lpht_look_up(join->table, key);
+    return first == NULL ? OHA_HJ_END : to_build_idx(*first);
+}
+
+size_t oha_hj_next(struct oha_hj * join, size_t build_idx)
+{
+    if (join == NULL || build_idx >= join->build_count) {
+        return OHA_HJ_END;
+    }
+    return to_build_idx(join->chain[build_idx]);
+}
+
+size_t oha_hj_probe(struct oha_hj * join,
+                    const void * probe_keys,
+                    size_t probe_count,
+                    struct oha_hj_cursor * cursor,
+                    struct oha_hj_match * matches,
+                    size_t max_matches)
+{
+    if (join == NULL || probe_keys == NULL || cursor == NULL || matches == NULL) {
+        return 0;
+    }
+
+    size_t n = 0;
+    // continue the chain of the last call
+    if (cursor->chain != 0) {
+        cursor->chain = write_matches(join, cursor->chain, cursor->probe_idx, matches, &n, max_matches);
+        if (cursor->chain != 0) {
+            return n;
+        }
+        cursor->probe_idx++;
+    }
+
+    void * values[PROBE_BLOCK_SIZE];
+    while (cursor->probe_idx < probe_count && n < max_matches) {
+        const size_t block = MIN(PROBE_BLOCK_SIZE, probe_count - cursor->probe_idx);
+        oha_lpht_look_up_batch(
+            join->table, (const uint8_t *)probe_keys + cursor->probe_idx * join->key_size, block, values);
+        // the second entries of the chains are the next cache misses
+        for (size_t i = 0; i < block; i++) {
+            if (values[i] != NULL) {
+                __builtin_prefetch(&join->chain[*(oha_capacity_t *)values[i] - 1]);
+            }
+        }
+
+        // the remaining keys of a block are looked up again on the next call, if the output gets full
+        for (size_t i = 0; i < block && n < max_matches; i++) {
+            if (values[i] != NULL) {
+                cursor->chain =
+                    write_matches(join, *(oha_capacity_t *)values[i], cursor->probe_idx, matches, &n, max_matches);
+                if (cursor->chain != 0) {
+                    return n;
+                }
+            }
+            cursor->probe_idx++;
+        }
+    }
+    return n;
+}
@@ -0,0 +1,320 @@
+#include "oha.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <xxhash.h>
+
+#include "utils.h"
+
+#define XXHASH_SEED 0xc800c831bc63dff8
+// number of buckets in a neighborhood, matches the bits of the hop bitmap
+#define NEIGHBORHOOD_SIZE 32
+
+struct bucket {
+    void * value;
+    uint32_t hop_info;    // bit i is set, if bucket home + i holds a key of this home bucket
+    uint32_t is_occupied; // only one bit in usage
+    // key buffer is always aligned on 32 bit and 64 bit architectures
+    uint8_t key_buffer[];
+};
+
+struct storage_info {
+    size_t key_size;
+    size_t value_size;
+    size_t bucket_size;
+    size_t table_size;
+    uint_fast32_t max_indicies;
+};
+
+struct oha_hsht {
+    struct oha_memory_fp memory;
+    uint64_t (*hash_fn)(const void * key, size_t key_size);
+    struct bucket * buckets;
+    void * values;
+    struct storage_info storage;
+    uint_fast32_t elems;
+    uint_fast32_t max_elems;
+};
+
+static int get_storage_values(const struct oha_lpht_config * config, struct storage_info * values)
+{
+    if (config == NULL || values == NULL) {
+        return EINVAL;
+    }
+    if (config->max_elems == 0 || config->value_size == 0 || config->key_size == 0 || config->load_factor <= 0.0 ||
+        config->load_factor >= 1.0) {
+        return EINVAL;
+    }
+    if (has_lpht_only_options(config)) {
+        return EINVAL;
+    }
+
+    // a neighborhood must not wrap around onto itself
+    double max_indicies = MAX(ceil((1 / config->load_factor) * config->max_elems) + 1, NEIGHBORHOOD_SIZE);
+    if (max_indicies > UINT32_MAX) {
+        return EINVAL;
+    }
+    values->max_indicies = max_indicies;
+    values->key_size = config->key_size;
+    values->value_size = add_alignment(config->value_size);
+    values->bucket_size = add_alignment(sizeof(struct bucket) + values->key_size);
+    values->table_size = sizeof(struct oha_hsht)                           // table space
+                         + values->bucket_size * values->max_indicies // keys
+                         + values->value_size * values->max_indicies;  // values
+    return 0;
+}
+
+// index must be lower than 2 * max_indicies, e.g. home + neighborhood offset
+static inline struct bucket * get_bucket(struct oha_hsht * table, size_t index)
+{
+    if (index >= table->storage.max_indicies) {
+        index -= table->storage.max_indicies;
+    }
+    return move_ptr_num_bytes(table->buckets, table->storage.bucket_size * index);
+}
+
+static struct oha_hsht * init_table_value(const struct oha_lpht_config * config,
+                                          const struct storage_info * storage,
+                                          struct oha_hsht * table)
+{
+    table->memory = config->memory;
+    table->hash_fn = config->hash_fn;
+    table->storage = *storage;
+    table->elems = 0;
+    table->max_elems = config->max_elems;
+    table->buckets = move_ptr_num_bytes(table, sizeof(struct oha_hsht));
+    table->values = move_ptr_num_bytes(table->buckets, storage->bucket_size * storage->max_indicies);
+
+    // connect buckets and values
+    for (size_t i = 0; i < storage->max_indicies; i++) {
+        struct bucket * bucket = get_bucket(table, i);
+        bucket->value = move_ptr_num_bytes(table->values, storage->value_size * i);
+        bucket->hop_info = 0;
+        bucket->is_occupied = 0;
+    }
+    return table;
+}
+
+static uint64_t hash_key(struct oha_hsht * table, const void * key)
+{
+    if (table->hash_fn != NULL) {
+        return table->hash_fn(key, table->storage.key_size);
+    }
+    return XXH64(key, table->storage.key_size, XXHASH_SEED);
+}
+
+// cyclic distance in buckets from index a to index b
+static size_t get_distance(struct oha_hsht * table, size_t a, size_t b)
+{
+    return (b + table->storage.max_indicies - a) % table->storage.max_indicies;
+}
+
+// returns the index of the key inside the neighborhood of home or -1
+static int find_in_neighborhood(struct oha_hsht * table, size_t home, const void * key)
+{
+    uint32_t hop_info = get_bucket(table, home)->hop_info;
+    while (hop_info != 0) {
+        int i = __builtin_ctz(hop_info);
+        struct bucket * bucket = get_bucket(table, home + i);
+        if (memcmp(bucket->key_buffer, key, table->storage.key_size) == 0) {
+            return i;
+        }
+        hop_info &= hop_info - 1;
+    }
+    return -1;
+}
+
+/*
+ * Moves an element with a neighborhood covering the free bucket into it and returns the new free bucket, which is
+ * closer to home. Returns free_index unchanged, if no element could be moved.
+ */
+static size_t move_free_bucket_closer(struct oha_hsht * table, size_t free_index)
+{
+    struct bucket * free_bucket = get_bucket(table, free_index);
+    const size_t n = table->storage.max_indicies;
+    for (size_t distance = NEIGHBORHOOD_SIZE - 1; distance > 0; distance--) {
+        size_t home = (free_index + n - distance) % n;
+        struct bucket * home_bucket = get_bucket(table, home);
+        // only elements in front of the free bucket can be moved
+        uint32_t movable = home_bucket->hop_info & (((uint32_t)1 << distance) - 1);
+        if (movable == 0) {
+            continue;
+        }
+        int i = __builtin_ctz(movable);
+        struct bucket * bucket = get_bucket(table, home + i);
+
+        void * tmp = free_bucket->value;
+        free_bucket->value = bucket->value;
+        bucket->value = tmp;
+        memcpy(free_bucket->key_buffer, bucket->key_buffer, table->storage.key_size);
+        free_bucket->is_occupied = 1;
+        bucket->is_occupied = 0;
+        home_bucket->hop_info &= ~((uint32_t)1 << i);
+        home_bucket->hop_info |= (uint32_t)1 << distance;
+        return (home + i) % n;
+    }
+    return free_index;
+}
+
+/*
+ * public functions
+ */
+
+size_t oha_hsht_calculate_size(const struct oha_lpht_config * config)
+{
+    struct storage_info storage;
+    if (get_storage_values(config, &storage) != 0) {
+        return 0;
+    }
+    return storage.table_size;
+}
+
+struct oha_hsht * oha_hsht_initialize(const struct oha_lpht_config * config, void * memory)
+{
+    struct oha_hsht * table = memory;
+    if (table == NULL) {
+        return NULL;
+    }
+    struct storage_info storage;
+    if (get_storage_values(config, &storage) != 0) {
+        return NULL;
+    }
+    return init_table_value(config, &storage, table);
+}
+
+struct oha_hsht * oha_hsht_create(const struct oha_lpht_config * config)
+{
+    struct storage_info storage;
+    if (get_storage_values(config, &storage) != 0) {
+        return NULL;
+    }
+    struct oha_hsht * table = oha_calloc(&config->memory, storage.table_size);
+    if (table == NULL) {
+        return NULL;
+    }
+    return init_table_value(config, &storage, table);
+}
+
+void oha_hsht_destroy(struct oha_hsht * table)
+{
+    if (table == NULL) {
+        return;
+    }
+    struct oha_memory_fp memory = table->memory;
+    oha_free(&memory, table);
+}
+
+// return pointer to value, touches only the neighborhood of the home bucket
+void * oha_hsht_look_up(struct oha_hsht * table, const void * key)
+{
+    if (table == NULL || key == NULL) {
+        return NULL;
+    }
+    size_t home = hash_key(table, key) % table->storage.max_indicies;
+    int i = find_in_neighborhood(table, home, key);
+    return i >= 0 ? get_bucket(table, home + i)->value : NULL;
+}
+
+// return pointer to value, inserted is set to true if the key was not in the table before
+void * oha_hsht_insert_ex(struct oha_hsht * table, const void * key, bool * inserted)
+{
+    if (inserted != NULL) {
+        *inserted = false;
+    }
+    if (table == NULL || key == NULL || inserted == NULL) {
+        return NULL;
+    }
+
+    size_t home = hash_key(table, key) % table->storage.max_indicies;
+    int i = find_in_neighborhood(table, home, key);
+    if (i >= 0) {
+        // already inserted
+        return get_bucket(table, home + i)->value;
+    }
+    if (table->elems >= table->max_elems) {
+        return NULL;
+    }
+
+    // find the next free bucket, there is always one because of the load factor
+    size_t free_index = home;
+    while (get_bucket(table, free_index)->is_occupied) {
+        free_index = (free_index + 1) % table->storage.max_indicies;
+    }
+
+    // displace elements until the free bucket is part of the neighborhood
+    while (get_distance(table, home, free_index) >= NEIGHBORHOOD_SIZE) {
+        size_t closer = move_free_bucket_closer(table, free_index);
+        if (closer == free_index) {
+            return NULL;
+        }
+        free_index = closer;
+    }
+
+    struct bucket * bucket = get_bucket(table, free_index);
+    memcpy(bucket->key_buffer, key, table->storage.key_size);
+    bucket->is_occupied = 1;
+    get_bucket(table, home)->hop_info |= (uint32_t)1 << get_distance(table, home, free_index);
+    table->elems++;
+    *inserted = true;
+    return bucket->value;
+}
+
+// return pointer to value
+void * oha_hsht_insert(struct oha_hsht * table, const void * key)
+{
+    bool inserted;
+    return oha_hsht_insert_ex(table, key, &inserted);
+}
+
+// return pointer to the removed value, the value is valid until the next insert
+void * oha_hsht_remove(struct oha_hsht * table, const void * key)
+{
+    if (table == NULL || key == NULL) {
+        return NULL;
+    }
+    size_t home = hash_key(table, key) % table->storage.max_indicies;
+    int i = find_in_neighborhood(table, home, key);
+    if (i < 0) {
+        return NULL;
+    }
+    struct bucket * bucket = get_bucket(table, home + i);
+    bucket->is_occupied = 0;
+    get_bucket(table, home)->hop_info &= ~((uint32_t)1 << i);
+    table->elems--;
+    return bucket->value;
+}
+
+struct oha_key_value_pair oha_hsht_get_next_element(struct oha_hsht * table, size_t * position)
+{
+    struct oha_key_value_pair pair = {0};
+    if (table == NULL || position == NULL) {
+        return pair;
+    }
+    while (*position < table->storage.max_indicies) {
+        struct bucket * bucket = get_bucket(table, *position);
+        (*position)++;
+        if (bucket->is_occupied) {
+            pair.key = bucket->key_buffer;
+            pair.value = bucket->value;
+            break;
+        }
+    }
+    return pair;
+}
+
+bool oha_hsht_get_status(struct oha_hsht * table, struct oha_lpht_status * status)
+{
+    if (table == NULL || status == NULL) {
+        return false;
+    }
+    memset(status, 0, sizeof(*status));
+    status->max_elems = table->max_elems;
+    status->elems_in_use = table->elems;
+    status->size_in_bytes = table->storage.table_size;
+    return true;
+}
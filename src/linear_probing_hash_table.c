@@ -6,92 +6,265 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include <xxhash.h>
 
+#ifdef __linux__
+#include <sys/random.h>
+#endif
+
+#include "batch_hash.h"
 #include "utils.h"
 
+#ifdef OHA_WITH_XXH3_DISPATCH
+// XXH3 of the vendored xxh_x86dispatch.c, runs the widest vector kernel of the CPU, bit identical to XXH3
+XXH64_hash_t XXH3_64bits_withSeed_dispatch(const void * input, size_t len, XXH64_hash_t seed);
+#define OHA_XXH3_64BITS_WITH_SEED XXH3_64bits_withSeed_dispatch
+#else
+#define OHA_XXH3_64BITS_WITH_SEED XXH3_64bits_withSeed
+#endif
+
 #define XXHASH_SEED 0xc800c831bc63dff8
+// partitions are routed independent of the table seed, it is the default seed so most tables reuse their hash
+#define PARTITION_SEED XXHASH_SEED
+#define FILTER_WORDS 8 // 32 bit words per filter block, one bit is set in each word
+#define FILTER_MAX_BITS_PER_ELEM 64
+#define BATCH_GROUP_SIZE 16 // look ups of one batch group, their memory accesses overlap
+#define HASH_COMPARE_MIN_KEY_SIZE 32 // shorter keys are compared faster directly than by their cached hash
+#define XXH3_MIN_KEY_SIZE 64          // longer keys are hashed with XXH3, which is faster than XXH64 on them
+#define STASH_SIZE 32                 // overflow buckets of max_probe tables, one bit each in stash_used
+#define STASH_OFFSET SIZE_MAX         // slot offset of reserved stash buckets
+#define STASH_RESEED_FILL (STASH_SIZE / 2) // stashed keys which mark a monitored table for a reseed
+
+#ifdef OHA_WITH_64BIT_CAPACITY
+#define MAX_INDICIES ((uint64_t)1 << 63)
+#else
+#define MAX_INDICIES ((uint64_t)UINT32_MAX)
+#endif
 
 #ifdef OHA_FIX_KEY_SIZE_IN_BYTES
 #if OHA_FIX_KEY_SIZE_IN_BYTES == 0
 #error "unsupported compile time key size"
 #endif
-// let the the compiler optimize memory calls by compile time constant
-#define MEMCPY_KEY(dest, src, n) memcpy(dest, src, OHA_FIX_KEY_SIZE_IN_BYTES);
-#define MEMCMP_KEY(a, b, n) memcmp(a, b, OHA_FIX_KEY_SIZE_IN_BYTES)
-#else
+#endif
+
+/*
+ * The hot path functions are implemented once as force inlined functions with the key size as parameter. The kernels
+ * below instantiate them with compile time constant key sizes, so the compiler can optimize the memory calls and the
+ * hashing. The kernel set is selected at table creation time by the configured key size.
+ */
 #define MEMCPY_KEY(dest, src, n) memcpy(dest, src, n);
 #define MEMCMP_KEY(a, b, n) memcmp(a, b, n)
+
+#ifdef OHA_WITH_STATS
+#define STATS_INC(table, counter) ((table)->statistics.counter++)
+#define STATS_ADD(table, counter, n) ((table)->statistics.counter += (n))
+#else
+#define STATS_INC(table, counter)
+#define STATS_ADD(table, counter, n)
 #endif
 
-#ifdef OHA_WITH_KEY_FROM_VALUE_SUPPORT
+// value layout of tables with key from value support, the back pointer is placed in front of the user value
 struct key_bucket;
 struct value_bucket {
     struct key_bucket * key;
     uint8_t value_buffer[];
 };
-#define VALUE_BUCKET_TYPE struct value_bucket
-#define TABLE_VALUE_BUCKET_SIZE sizeof(struct value_bucket)
-#else
-#define VALUE_BUCKET_TYPE void
-#define TABLE_VALUE_BUCKET_SIZE 0
-#endif
 
 struct key_bucket {
-    VALUE_BUCKET_TYPE * value;
+    void * value; // points always to the user value, independent of the value layout
+#ifdef OHA_WITH_64BIT_CAPACITY
+    // keeps the bucket header at 16 bytes
+    uint64_t offset : 63;
+    uint64_t is_occupied : 1;
+#else
     uint32_t offset;
     uint32_t is_occupied; // only one bit in usage, could be extend for future states
+#endif
     // key buffer is always aligned on 32 bit and 64 bit architectures
     uint8_t key_buffer[];
 };
 
+// 256 bit block of the bloom filter, all bits of one key are in the same block
+struct filter_block {
+    uint32_t words[FILTER_WORDS];
+};
+
 struct storage_info {
     size_t key_size;            // origin configuration key size in bytes
     size_t value_size;          // origin configuration value size in bytes
     size_t key_bucket_size;     // size in bytes of one whole hash table key bucket, memory aligned
     size_t hash_table_size;     // size in bytes of the hole hash table memory
-    uint_fast32_t max_indicies; // number of all allocated hash table buckets
+    size_t filter_blocks;       // number of bloom filter blocks, 0 if the filter is disabled
+    size_t max_indicies;        // number of hash table buckets, without the stash
+    size_t stash_size;          // overflow buckets behind the hash table buckets, 0 if max_probe is disabled
+    size_t hash_offset;         // offset of the cached hash inside a key bucket, 0 if the hashes are not cached
+    bool key_from_value;        // values are stored as struct value_bucket with a back pointer to the key
+};
+
+struct oha_lpht;
+struct merge_args;
+
+struct lpht_kernels {
+    void * (*look_up)(struct oha_lpht * table, const void * key);
+    void * (*insert)(struct oha_lpht * table, const void * key, bool * inserted);
+    void * (*prepare_insert)(struct oha_lpht * table, const void * key, struct oha_lpht_slot * slot);
+    void * (*remove)(struct oha_lpht * table, const void * key);
+    void (*look_up_batch)(struct oha_lpht * table, const void * keys, size_t count, void ** values);
+    const void * (*probe_init)(struct oha_lpht * table, struct oha_lpht_probe * probe, const void * key);
+    bool (*probe_step)(struct oha_lpht * table, struct oha_lpht_probe * probe, void ** value);
+    bool (*merge)(struct oha_lpht * dst, struct oha_lpht * src, const struct merge_args * args);
+    size_t (*add_u64_batch)(struct oha_lpht * table, const void * keys, const uint64_t * deltas, size_t count);
 };
 
 struct oha_lpht {
-    VALUE_BUCKET_TYPE * value_buckets;
+    const struct lpht_kernels * kernels;
+    uint64_t (*hash_fn)(const void * key, size_t key_size);
+    uint64_t seed; // seed of the built-in hash
+    void * value_buckets;
     struct key_bucket * key_buckets;
     struct key_bucket * last_key_bucket;
     struct key_bucket * current_bucket_to_clear;
+    struct filter_block * filter;
+    uint64_t * stash_hashes; // hashes of the stash buckets, scanned at once
     struct storage_info storage;
-    uint_fast32_t elems; // current number of inserted elements
+    struct oha_memory_fp memory;
+    struct oha_lpht_config config; // origin configuration, the base of oha_lpht_rehash()
+    oha_capacity_t elems; // current number of inserted elements
     /*
      * The maximum number of elements that could placed in the table, this value is lower than the allocated
      * number of hash table buckets, because of performance reasons. The ratio is configurable via the load factor.
      */
-    uint_fast32_t max_elems;
+    oha_capacity_t max_elems;
+    oha_capacity_t filter_stale_keys; // removed keys, which are still set in the filter
+    size_t reseed_probe_length;       // SIZE_MAX if the hash flooding monitor is disabled
+    size_t max_probe;                 // SIZE_MAX if the probe sequences are unbounded
+    size_t max_offset;                // highest offset of an inserted key
+    uint32_t stash_used;              // bit mask of the occupied stash buckets
+    bool reseed_pending;
     bool clear_mode_on;
+    bool owns_memory; // allocated by the library, only these tables may be released by a rehash
+#ifdef OHA_WITH_STATS
+    struct oha_lpht_statistics statistics;
+#endif
 };
 
 static inline void * get_value(struct key_bucket * bucket)
 {
-#ifdef OHA_WITH_KEY_FROM_VALUE_SUPPORT
-    return bucket->value->value_buffer;
-#else
     return bucket->value;
-#endif
+}
+
+static inline struct value_bucket * get_value_bucket(void * value)
+{
+    return (struct value_bucket *)((uint8_t *)value - offsetof(struct value_bucket, value_buffer));
+}
+
+static inline uint64_t * get_cached_hash(struct oha_lpht * table, struct key_bucket * bucket)
+{
+    return move_ptr_num_bytes(bucket, table->storage.hash_offset);
+}
+
+// moves the key and the cached hash of src into the free bucket dest
+OHA_FORCE_INLINE void
+move_key(struct oha_lpht * table, struct key_bucket * restrict dest, struct key_bucket * restrict src, size_t key_size)
+{
+    MEMCPY_KEY(dest->key_buffer, src->key_buffer, key_size);
+    if (table->storage.hash_offset != 0) {
+        *get_cached_hash(table, dest) = *get_cached_hash(table, src);
+    }
+}
+
+// long keys are only compared if the cached hashes are equal
+OHA_FORCE_INLINE bool
+keys_equal(struct oha_lpht * table, struct key_bucket * bucket, const void * key, uint64_t hash, size_t key_size)
+{
+    if (key_size >= HASH_COMPARE_MIN_KEY_SIZE && table->storage.hash_offset != 0 &&
+        *get_cached_hash(table, bucket) != hash) {
+        return false;
+    }
+    STATS_INC(table, key_compares);
+    return MEMCMP_KEY(bucket->key_buffer, key, key_size) == 0;
 }
 
 // does not support overflow
-static void * get_next_value(struct oha_lpht * table, VALUE_BUCKET_TYPE * value)
+static void * get_next_value(struct oha_lpht * table, void * value)
 {
     return move_ptr_num_bytes(value, table->storage.value_size);
 }
 
-static uint64_t hash_key(struct oha_lpht * table, const void * key)
+OHA_FORCE_INLINE uint64_t hash_key_seeded(const void * key, size_t key_size, uint64_t seed)
 {
-#ifdef OHA_FIX_KEY_SIZE_IN_BYTES
-    (void)table;
-    return XXH64(key, OHA_FIX_KEY_SIZE_IN_BYTES, XXHASH_SEED);
-#else
-    return XXH64(key, table->storage.key_size, XXHASH_SEED);
+    if (key_size >= XXH3_MIN_KEY_SIZE) {
+        return OHA_XXH3_64BITS_WITH_SEED(key, key_size, seed);
+    }
+    return XXH64(key, key_size, seed);
+}
+
+OHA_FORCE_INLINE uint64_t hash_key(struct oha_lpht * table, const void * key, size_t key_size, bool custom_hash)
+{
+    if (custom_hash) {
+        return table->hash_fn(key, key_size);
+    }
+    return hash_key_seeded(key, key_size, table->seed);
+}
+
+// hashes a group of contiguous keys, 4 and 8 byte keys with the built-in hash are hashed by the vector units
+OHA_FORCE_INLINE void
+hash_keys(struct oha_lpht * table, const uint8_t * keys, size_t n, uint64_t * hashes, size_t key_size, bool custom_hash)
+{
+#ifdef OHA_WITH_BATCH_HASH
+    if (!custom_hash && (key_size == 4 || key_size == 8)) {
+        oha_xxh64_batch(keys, key_size, n, table->seed, hashes);
+        return;
+    }
 #endif
+    for (size_t i = 0; i < n; i++) {
+        hashes[i] = hash_key(table, keys + i * key_size, key_size, custom_hash);
+    }
+}
+
+/*
+ * The filter uses a remixed hash, so custom hash functions with weak upper bits (e.g. identity hashes) still spread
+ * over all blocks. The upper bits select the block, the lower bits select one bit per word.
+ */
+OHA_FORCE_INLINE struct filter_block * get_filter_block(struct oha_lpht * table, uint64_t mixed)
+{
+    size_t index = ((mixed >> 32) * table->storage.filter_blocks) >> 32;
+    return &table->filter[index];
+}
+
+OHA_FORCE_INLINE uint32_t get_filter_bit(uint64_t mixed, size_t word)
+{
+    static const uint32_t salt[FILTER_WORDS] = {
+        0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU, 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+    return (uint32_t)1 << (((uint32_t)mixed * salt[word]) >> 27);
+}
+
+OHA_FORCE_INLINE uint64_t mix_filter_hash(uint64_t hash)
+{
+    return hash * 0x9e3779b97f4a7c15;
+}
+
+OHA_FORCE_INLINE void filter_add(struct oha_lpht * table, uint64_t hash)
+{
+    uint64_t mixed = mix_filter_hash(hash);
+    struct filter_block * block = get_filter_block(table, mixed);
+    for (size_t i = 0; i < FILTER_WORDS; i++) {
+        block->words[i] |= get_filter_bit(mixed, i);
+    }
+}
+
+OHA_FORCE_INLINE bool filter_may_contain(struct oha_lpht * table, uint64_t hash)
+{
+    uint64_t mixed = mix_filter_hash(hash);
+    const struct filter_block * block = get_filter_block(table, mixed);
+    bool contained = true;
+    for (size_t i = 0; i < FILTER_WORDS; i++) {
+        uint32_t bit = get_filter_bit(mixed, i);
+        contained &= (block->words[i] & bit) == bit;
+    }
+    return contained;
 }
 
 static struct key_bucket * get_start_bucket(struct oha_lpht * table, uint64_t hash)
@@ -111,269 +284,567 @@ static struct key_bucket * get_next_bucket(struct oha_lpht * table, struct key_b
     return current;
 }
 
-static void swap_bucket_values(struct key_bucket * restrict a, struct key_bucket * restrict b)
+static struct key_bucket * get_bucket(struct oha_lpht * table, size_t index)
 {
-#ifdef OHA_WITH_KEY_FROM_VALUE_SUPPORT
-    a->value->key = b;
-    b->value->key = a;
-#endif
-    VALUE_BUCKET_TYPE * tmp = a->value;
-    a->value = b->value;
-    b->value = tmp;
+    return move_ptr_num_bytes(table->key_buckets, table->storage.key_bucket_size * index);
 }
 
-static int get_storage_values(const struct oha_lpht_config * config, struct storage_info * values)
+// hash table buckets and stash buckets, for sweeps over all keys
+static size_t get_num_buckets(const struct oha_lpht * table)
 {
-    if (config == NULL || values == NULL) {
-        return EINVAL;
-    }
+    return table->storage.max_indicies + table->storage.stash_size;
+}
 
-    // TODO support zero value size as hash set
-    if (config->max_elems == 0 || config->value_size == 0 || config->load_factor <= 0.0 || config->load_factor >= 1.0) {
-        return EINVAL;
-    }
+static inline struct key_bucket * get_stash_bucket(struct oha_lpht * table, uint32_t slot)
+{
+    return get_bucket(table, table->storage.max_indicies + slot);
+}
 
-#ifndef OHA_FIX_KEY_SIZE_IN_BYTES
-    if (config->key_size == 0) {
-        return EINVAL;
+// compares the hashes of all stash buckets in one loop, only equal hashes compare their keys. Returns the slot or -1.
+OHA_FORCE_INLINE int find_in_stash(struct oha_lpht * table, const void * key, uint64_t hash, size_t key_size)
+{
+    uint32_t candidates = 0;
+    for (uint32_t i = 0; i < STASH_SIZE; i++) {
+        candidates |= (uint32_t)(table->stash_hashes[i] == hash) << i;
     }
-    values->key_size = config->key_size;
-#else
-    values->key_size = OHA_FIX_KEY_SIZE_IN_BYTES;
-#endif
+    candidates &= table->stash_used;
+    while (candidates != 0) {
+        int slot = __builtin_ctz(candidates);
+        STATS_INC(table, key_compares);
+        if (MEMCMP_KEY(get_stash_bucket(table, slot)->key_buffer, key, key_size) == 0) {
+            return slot;
+        }
+        candidates &= candidates - 1;
+    }
+    return -1;
+}
 
-    // TODO add overflow checks
-    values->max_indicies = ceil((1 / config->load_factor) * config->max_elems) + 1;
-    values->value_size = TABLE_VALUE_BUCKET_SIZE + add_alignment(config->value_size);
-    values->key_bucket_size = add_alignment(sizeof(struct key_bucket) + values->key_size);
-    values->hash_table_size = sizeof(struct oha_lpht)                          // table space
-                              + values->key_bucket_size * values->max_indicies // keys
-                              + values->value_size * values->max_indicies;     // values
+static void free_stash_slot(struct oha_lpht * table, uint32_t slot)
+{
+    get_stash_bucket(table, slot)->is_occupied = 0;
+    table->stash_used &= ~((uint32_t)1 << slot);
+}
 
-    return 0;
+// cyclic distance in buckets from index a to index b
+static size_t get_distance(struct oha_lpht * table, size_t a, size_t b)
+{
+    return (b + table->storage.max_indicies - a) % table->storage.max_indicies;
 }
 
-static struct oha_lpht * init_table_value(const struct oha_lpht_config * config,
-                                          const struct storage_info * storage,
-                                          struct oha_lpht * table)
+static void swap_bucket_values(struct oha_lpht * table, struct key_bucket * restrict a, struct key_bucket * restrict b)
 {
-    table->storage = *storage;
-    table->key_buckets = move_ptr_num_bytes(table, sizeof(struct oha_lpht));
-    table->last_key_bucket =
-        move_ptr_num_bytes(table->key_buckets, table->storage.key_bucket_size * (table->storage.max_indicies - 1));
-    table->value_buckets = move_ptr_num_bytes(table->last_key_bucket, table->storage.key_bucket_size);
-    table->max_elems = config->max_elems;
-    table->current_bucket_to_clear = NULL;
-    table->clear_mode_on = false;
+    if (table->storage.key_from_value) {
+        get_value_bucket(a->value)->key = b;
+        get_value_bucket(b->value)->key = a;
+    }
+    void * tmp = a->value;
+    a->value = b->value;
+    b->value = tmp;
+}
 
-    // connect hash buckets and value buckets
-    struct key_bucket * current_key_bucket = table->key_buckets;
-    VALUE_BUCKET_TYPE * current_value_bucket = table->value_buckets;
-    for (size_t i = 0; i < table->storage.max_indicies; i++) {
-        current_key_bucket->value = current_value_bucket;
-#ifdef OHA_WITH_KEY_FROM_VALUE_SUPPORT
-        current_value_bucket->key = current_key_bucket;
-#endif
-        current_key_bucket = get_next_bucket(table, current_key_bucket);
-        current_value_bucket = get_next_value(table, current_value_bucket);
+static void rebuild_filter(struct oha_lpht * table)
+{
+    STATS_INC(table, filter_rebuilds);
+    memset(table->filter, 0, sizeof(struct filter_block) * table->storage.filter_blocks);
+    for (size_t i = 0; i < get_num_buckets(table); i++) {
+        struct key_bucket * bucket = get_bucket(table, i);
+        if (!bucket->is_occupied) {
+            continue;
+        }
+        if (table->storage.hash_offset != 0) {
+            filter_add(table, *get_cached_hash(table, bucket));
+        } else {
+            filter_add(table, hash_key(table, bucket->key_buffer, table->storage.key_size, table->hash_fn != NULL));
+        }
+    }
+    table->filter_stale_keys = 0;
+}
+
+// bloom filters do not support deletion, the filter is rebuild once the removed keys would raise the false positives
+static void add_filter_stale_keys(struct oha_lpht * table, oha_capacity_t removed)
+{
+    table->filter_stale_keys += removed;
+    if (table->filter_stale_keys > table->max_elems / 2) {
+        rebuild_filter(table);
     }
-    return table;
 }
 
 // restores the hash table invariant
-static void probify(struct oha_lpht * table, struct key_bucket * start_bucket, uint_fast32_t offset)
+OHA_FORCE_INLINE void
+probify(struct oha_lpht * table, struct key_bucket * start_bucket, size_t offset, size_t key_size)
 {
     struct key_bucket * bucket = start_bucket;
-    uint_fast32_t i = 0;
-    do {
+    size_t i = 0;
+    while (true) {
         offset++;
         i++;
         bucket = get_next_bucket(table, bucket);
+        if (!bucket->is_occupied) {
+            return;
+        }
+        STATS_INC(table, probe_steps);
         if (bucket->offset >= offset || bucket->offset >= i) {
-            swap_bucket_values(start_bucket, bucket);
-            MEMCPY_KEY(start_bucket->key_buffer, bucket->key_buffer, table->storage.key_size);
+            STATS_INC(table, probify_moves);
+            swap_bucket_values(table, start_bucket, bucket);
+            move_key(table, start_bucket, bucket, key_size);
             start_bucket->offset = bucket->offset - i;
             start_bucket->is_occupied = 1;
             bucket->is_occupied = 0;
             bucket->offset = 0;
-            probify(table, bucket, offset);
-            return;
+            // continue with the new hole
+            start_bucket = bucket;
+            i = 0;
         }
-    } while (bucket->is_occupied);
+    }
 }
 
-/*
- * public functions
- */
-
-void oha_lpht_destroy(struct oha_lpht * table)
+// walks the cluster from the start bucket of the key, at most max_probe buckets, and the stash afterwards
+OHA_FORCE_INLINE void *
+probe_cluster(struct oha_lpht * table, struct key_bucket * bucket, const void * key, uint64_t hash, size_t key_size)
 {
-    free(table);
+    for (size_t offset = 0; bucket->is_occupied && offset < table->max_probe; offset++) {
+        STATS_INC(table, probe_steps);
+        // circle + length check
+        if (keys_equal(table, bucket, key, hash, key_size)) {
+            STATS_INC(table, hits);
+            return get_value(bucket);
+        }
+        bucket = get_next_bucket(table, bucket);
+    }
+    if (table->stash_used != 0) {
+        int slot = find_in_stash(table, key, hash, key_size);
+        if (slot >= 0) {
+            STATS_INC(table, hits);
+            return get_value(get_stash_bucket(table, slot));
+        }
+    }
+    STATS_INC(table, misses);
+    return NULL;
 }
 
-size_t oha_lpht_calculate_size(const struct oha_lpht_config * config)
+OHA_FORCE_INLINE void *
+look_up_impl(struct oha_lpht * table, const void * key, size_t key_size, bool custom_hash, bool filter)
 {
-    struct storage_info storage;
-    if (get_storage_values(config, &storage) != 0) {
-        return 0;
+    STATS_INC(table, look_ups);
+    uint64_t hash = hash_key(table, key, key_size, custom_hash);
+    if (filter && !filter_may_contain(table, hash)) {
+        STATS_INC(table, filter_rejects);
+        STATS_INC(table, misses);
+        return NULL;
     }
-    return storage.hash_table_size;
+    return probe_cluster(table, get_start_bucket(table, hash), key, hash, key_size);
 }
 
-struct oha_lpht * oha_lpht_initialize(const struct oha_lpht_config * config, void * memory)
+OHA_FORCE_INLINE void look_up_batch_impl(struct oha_lpht * table,
+                                         const void * keys,
+                                         size_t count,
+                                         void ** values,
+                                         size_t key_size,
+                                         bool custom_hash,
+                                         bool filter)
 {
-    struct oha_lpht * table = memory;
-    if (table == NULL) {
-        return NULL;
-    }
-    struct storage_info storage;
-    if (get_storage_values(config, &storage) != 0) {
-        return NULL;
+    uint64_t hashes[BATCH_GROUP_SIZE];
+    struct key_bucket * buckets[BATCH_GROUP_SIZE];
+    for (size_t start = 0; start < count; start += BATCH_GROUP_SIZE) {
+        const size_t n = MIN(BATCH_GROUP_SIZE, count - start);
+        const uint8_t * group_keys = (const uint8_t *)keys + start * key_size;
+
+        // 1. hash the group and prefetch the first touched cache line of every key
+        hash_keys(table, group_keys, n, hashes, key_size, custom_hash);
+        for (size_t i = 0; i < n; i++) {
+            if (filter) {
+                __builtin_prefetch(get_filter_block(table, mix_filter_hash(hashes[i])));
+            } else {
+                buckets[i] = get_start_bucket(table, hashes[i]);
+                __builtin_prefetch(buckets[i]);
+            }
+        }
+        // 2. filter the misses out and prefetch the buckets of the remaining keys
+        if (filter) {
+            for (size_t i = 0; i < n; i++) {
+                if (filter_may_contain(table, hashes[i])) {
+                    buckets[i] = get_start_bucket(table, hashes[i]);
+                    __builtin_prefetch(buckets[i]);
+                } else {
+                    buckets[i] = NULL;
+                }
+            }
+        }
+        // 3. walk the clusters, the first buckets are in the cache now
+        for (size_t i = 0; i < n; i++) {
+            STATS_INC(table, look_ups);
+            if (filter && buckets[i] == NULL) {
+                STATS_INC(table, filter_rejects);
+                STATS_INC(table, misses);
+                values[start + i] = NULL;
+                continue;
+            }
+            values[start + i] = probe_cluster(table, buckets[i], group_keys + i * key_size, hashes[i], key_size);
+        }
     }
-    return init_table_value(config, &storage, table);
 }
 
-struct oha_lpht * oha_lpht_create(const struct oha_lpht_config * config)
+OHA_FORCE_INLINE const void *
+probe_init_impl(struct oha_lpht * table, struct oha_lpht_probe * probe, const void * key, size_t key_size, bool custom_hash)
 {
-    struct storage_info storage;
-    if (get_storage_values(config, &storage) != 0) {
-        return NULL;
-    }
-    struct oha_lpht * table = calloc(1, storage.hash_table_size);
-    if (table == NULL) {
-        return NULL;
-    }
-    return init_table_value(config, &storage, table);
+    STATS_INC(table, look_ups);
+    probe->key = key;
+    probe->hash = hash_key(table, key, key_size, custom_hash);
+    probe->offset = 0;
+    probe->bucket = get_start_bucket(table, probe->hash);
+    return probe->bucket;
 }
 
-// return pointer to value
-void * oha_lpht_look_up(struct oha_lpht * table, const void * key)
+/*
+ * Visits the buckets of the current cache line. Returns false with the next bucket in probe->bucket if the probe
+ * sequence continues on another cache line.
+ */
+OHA_FORCE_INLINE bool
+probe_step_impl(struct oha_lpht * table, struct oha_lpht_probe * probe, void ** value, size_t key_size)
 {
-    if (table == NULL || key == NULL) {
-        return NULL;
+    struct key_bucket * bucket = probe->bucket;
+    while (bucket->is_occupied && probe->offset < table->max_probe) {
+        STATS_INC(table, probe_steps);
+        STATS_INC(table, key_compares);
+        if (MEMCMP_KEY(bucket->key_buffer, probe->key, key_size) == 0) {
+            STATS_INC(table, hits);
+            *value = get_value(bucket);
+            return true;
+        }
+        probe->offset++;
+        struct key_bucket * next = get_next_bucket(table, bucket);
+        if ((uintptr_t)next / CACHE_LINE_SIZE != (uintptr_t)bucket / CACHE_LINE_SIZE) {
+            probe->bucket = next;
+            return false;
+        }
+        bucket = next;
     }
-    uint64_t hash = hash_key(table, key);
-    struct key_bucket * bucket = get_start_bucket(table, hash);
-    while (bucket->is_occupied) {
-        // circle + length check
-        if (MEMCMP_KEY(bucket->key_buffer, key, table->storage.key_size) == 0) {
-            return get_value(bucket);
+    if (table->stash_used != 0) {
+        int slot = find_in_stash(table, probe->key, probe->hash, key_size);
+        if (slot >= 0) {
+            STATS_INC(table, hits);
+            *value = get_value(get_stash_bucket(table, slot));
+            return true;
         }
-        bucket = get_next_bucket(table, bucket);
     }
-    return NULL;
+    STATS_INC(table, misses);
+    *value = NULL;
+    return true;
 }
 
-// return pointer to value
-void * oha_lpht_insert(struct oha_lpht * table, const void * key)
+// writes the key and its cached hash into the free bucket, it is inserted only by commit_insert_impl()
+OHA_FORCE_INLINE void * reserve_bucket(struct oha_lpht * table,
+                                       struct key_bucket * bucket,
+                                       const void * key,
+                                       size_t offset,
+                                       struct oha_lpht_slot * slot,
+                                       size_t key_size)
 {
-    if (table == NULL || key == NULL) {
-        return NULL;
+    MEMCPY_KEY(bucket->key_buffer, key, key_size);
+    if (table->storage.hash_offset != 0) {
+        *get_cached_hash(table, bucket) = slot->hash;
     }
-    if (table->elems >= table->max_elems) {
+    slot->bucket = bucket;
+    slot->offset = offset;
+    return get_value(bucket);
+}
+
+// cold path of inserts, whose first max_probe buckets are occupied by other keys
+static void *
+prepare_insert_stash(struct oha_lpht * table, const void * key, struct oha_lpht_slot * slot, size_t key_size)
+{
+    int stash_slot = find_in_stash(table, key, slot->hash, key_size);
+    if (stash_slot >= 0) {
+        // already inserted
+        return get_value(get_stash_bucket(table, stash_slot));
+    }
+    if (table->elems >= table->max_elems || table->stash_used == UINT32_MAX) {
+        STATS_INC(table, insert_failures_full);
         return NULL;
     }
+    struct key_bucket * bucket = get_stash_bucket(table, __builtin_ctz(~table->stash_used));
+    return reserve_bucket(table, bucket, key, STASH_OFFSET, slot, key_size);
+}
 
-    uint64_t hash = hash_key(table, key);
+/*
+ * First phase of an insert, probes for the key and reserves the free bucket of a new key. Returns the value of the
+ * found key (slot->bucket is NULL), the value of the reserved bucket or NULL if the table is full.
+ */
+OHA_FORCE_INLINE void * prepare_insert_hashed_impl(
+    struct oha_lpht * table, const void * key, uint64_t hash, struct oha_lpht_slot * slot, size_t key_size)
+{
+    slot->bucket = NULL;
+    slot->hash = hash;
     struct key_bucket * bucket = get_start_bucket(table, hash);
 
-    uint_fast32_t offset = 0;
+    size_t offset = 0;
     while (bucket->is_occupied) {
-        if (MEMCMP_KEY(bucket->key_buffer, key, table->storage.key_size) == 0) {
+        STATS_INC(table, probe_steps);
+        if (keys_equal(table, bucket, key, hash, key_size)) {
             // already inserted
             return get_value(bucket);
         }
         bucket = get_next_bucket(table, bucket);
         offset++;
+        if (offset == table->max_probe) {
+            return prepare_insert_stash(table, key, slot, key_size);
+        }
     }
 
-    // insert key
-    MEMCPY_KEY(bucket->key_buffer, key, table->storage.key_size);
-    bucket->offset = offset;
-    bucket->is_occupied = 1;
-
-    table->elems++;
-    return get_value(bucket);
-}
+    // the key could have overflowed into the stash, while its probe sequence was full
+    if (table->stash_used != 0) {
+        int stash_slot = find_in_stash(table, key, hash, key_size);
+        if (stash_slot >= 0) {
+            return get_value(get_stash_bucket(table, stash_slot));
+        }
+    }
 
-void * oha_lpht_get_key_from_value(const void * value)
-{
-#ifdef OHA_WITH_KEY_FROM_VALUE_SUPPORT
-    if (value == NULL) {
+    // the key is new, check the capacity only now to find already inserted keys in a full table, too
+    if (table->elems >= table->max_elems) {
+        STATS_INC(table, insert_failures_full);
         return NULL;
     }
-    struct value_bucket * value_bucket =
-        (struct value_bucket *)((uint8_t *)value - offsetof(struct value_bucket, value_buffer));
-    assert(value_bucket->key->value == value_bucket);
-    return value_bucket->key;
-#else
-    (void)value;
-    return NULL;
-#endif
+    return reserve_bucket(table, bucket, key, offset, slot, key_size);
 }
 
-void oha_lpht_clear(struct oha_lpht * table)
+// second phase of an insert, marks the reserved bucket as occupied without probing again
+OHA_FORCE_INLINE void * commit_insert_impl(struct oha_lpht * table, struct oha_lpht_slot * slot, bool filter)
 {
-    if (table == NULL) {
-        return;
+    struct key_bucket * bucket = slot->bucket;
+    if (slot->offset == STASH_OFFSET) {
+        size_t stash_offset = (uint8_t *)bucket - (uint8_t *)get_stash_bucket(table, 0);
+        uint32_t stash_slot = stash_offset / table->storage.key_bucket_size;
+        bucket->offset = 0;
+        table->stash_hashes[stash_slot] = slot->hash;
+        table->stash_used |= (uint32_t)1 << stash_slot;
+        STATS_INC(table, stash_inserts);
+        /*
+         * Stashed keys probed more than max_probe buckets. If that is below the reseed_probe_length, no insert
+         * reaches it, so a filling stash marks the table before colliding keys fill it up.
+         */
+        if (table->reseed_probe_length != SIZE_MAX &&
+            (table->max_probe > table->reseed_probe_length ||
+             __builtin_popcount(table->stash_used) >= STASH_RESEED_FILL)) {
+            table->reseed_pending = true;
+        }
+    } else {
+        bucket->offset = slot->offset;
+        if (slot->offset > table->max_offset) {
+            table->max_offset = slot->offset;
+        }
+        if (slot->offset > table->reseed_probe_length) {
+            table->reseed_pending = true;
+        }
     }
-    if (!table->clear_mode_on) {
-        table->clear_mode_on = true;
-        table->current_bucket_to_clear = table->key_buckets;
+    bucket->is_occupied = 1;
+    if (filter) {
+        filter_add(table, slot->hash);
     }
+
+    table->elems++;
+    slot->bucket = NULL;
+    return get_value(bucket);
 }
 
-struct oha_key_value_pair oha_lpht_get_next_element_to_remove(struct oha_lpht * table)
+OHA_FORCE_INLINE void *
+insert_hashed_impl(struct oha_lpht * table, const void * key, uint64_t hash, bool * inserted, size_t key_size, bool filter)
 {
-    struct oha_key_value_pair pair = {0};
-    if (table == NULL || !table->clear_mode_on) {
-        return pair;
-    }
-    bool stop = false;
-
-    while (table->current_bucket_to_clear <= table->last_key_bucket) {
-        if (table->current_bucket_to_clear->is_occupied) {
-            pair.value = get_value(table->current_bucket_to_clear);
-            pair.key = table->current_bucket_to_clear->key_buffer;
-            stop = true;
-        }
-        table->current_bucket_to_clear =
-            move_ptr_num_bytes(table->current_bucket_to_clear, table->storage.key_bucket_size);
-        if (stop == true) {
-            break;
-        }
+    struct oha_lpht_slot slot;
+    void * value = prepare_insert_hashed_impl(table, key, hash, &slot, key_size);
+    if (slot.bucket == NULL) {
+        return value;
     }
+    *inserted = true;
+    return commit_insert_impl(table, &slot, filter);
+}
 
-    return pair;
+OHA_FORCE_INLINE void *
+insert_impl(struct oha_lpht * table, const void * key, bool * inserted, size_t key_size, bool custom_hash, bool filter)
+{
+    return insert_hashed_impl(table, key, hash_key(table, key, key_size, custom_hash), inserted, key_size, filter);
 }
 
-// return true if element was in the table
-void * oha_lpht_remove(struct oha_lpht * table, const void * key)
+OHA_FORCE_INLINE void * prepare_insert_impl(
+    struct oha_lpht * table, const void * key, struct oha_lpht_slot * slot, size_t key_size, bool custom_hash)
 {
-    uint64_t hash = hash_key(table, key);
+    return prepare_insert_hashed_impl(table, key, hash_key(table, key, key_size, custom_hash), slot, key_size);
+}
+
+// the range of a hash for oha_lpht_merge_partition() and oha_lpht_get_partition()
+static inline uint32_t get_hash_partition(uint64_t hash, uint32_t num_partitions)
+{
+    return ((hash >> 32) * num_partitions) >> 32;
+}
+
+/*
+ * Partition of a key with its table hash. Tables with different seeds (e.g. after oha_lpht_auto_reseed()) have to
+ * agree on the partitions, so only hashes of the partition seed are used directly.
+ */
+OHA_FORCE_INLINE uint32_t get_key_partition(
+    struct oha_lpht * table, const void * key, uint64_t hash, uint32_t num_partitions, size_t key_size, bool custom_hash)
+{
+    if (!custom_hash && table->seed != PARTITION_SEED) {
+        hash = hash_key_seeded(key, key_size, PARTITION_SEED);
+    }
+    return get_hash_partition(hash, num_partitions);
+}
+
+struct merge_args {
+    void (*combine)(const void * key, void * dst_value, const void * src_value, void * context);
+    void * context;
+    uint32_t partition;
+    uint32_t num_partitions; // 0 merges all keys
+};
+
+// size of the user value without the back pointer of key_from_value tables
+static size_t get_user_value_size(const struct oha_lpht * table)
+{
+    return table->storage.value_size - (table->storage.key_from_value ? sizeof(struct value_bucket) : 0);
+}
+
+/*
+ * Walks src sequentially and inserts the keys in groups into dst. The start buckets of a group are prefetched before
+ * the group is inserted.
+ */
+OHA_FORCE_INLINE bool merge_impl(struct oha_lpht * dst,
+                                 struct oha_lpht * src,
+                                 const struct merge_args * args,
+                                 size_t key_size,
+                                 bool custom_hash,
+                                 bool filter)
+{
+    const void * keys[BATCH_GROUP_SIZE];
+    const void * values[BATCH_GROUP_SIZE];
+    uint64_t hashes[BATCH_GROUP_SIZE];
+    const size_t value_size = get_user_value_size(dst);
+    const size_t max_indicies = get_num_buckets(src);
+    // the cached hashes of src are valid for dst, if both use the same hash function and seed
+    const bool reuse_hashes = src->storage.hash_offset != 0 && src->hash_fn == dst->hash_fn && src->seed == dst->seed;
+    size_t n = 0;
+    for (size_t i = 0; i < max_indicies || n > 0;) {
+        // 1. collect a group of src keys
+        for (; i < max_indicies && n < BATCH_GROUP_SIZE; i++) {
+            struct key_bucket * bucket = get_bucket(src, i);
+            if (!bucket->is_occupied) {
+                continue;
+            }
+            uint64_t hash = reuse_hashes ? *get_cached_hash(src, bucket)
+                                         : hash_key(dst, bucket->key_buffer, key_size, custom_hash);
+            // hash belongs to the seed of dst, either computed or reused from src with the same seed
+            if (args->num_partitions > 0 &&
+                get_key_partition(dst, bucket->key_buffer, hash, args->num_partitions, key_size, custom_hash) !=
+                    args->partition) {
+                continue;
+            }
+            hashes[n] = hash;
+            keys[n] = bucket->key_buffer;
+            values[n] = get_value(bucket);
+            __builtin_prefetch(get_start_bucket(dst, hash), 1);
+            n++;
+        }
+
+        // 2. insert or combine the group
+        for (size_t j = 0; j < n; j++) {
+            bool inserted = false;
+            void * value = insert_hashed_impl(dst, keys[j], hashes[j], &inserted, key_size, filter);
+            if (value == NULL) {
+                return false;
+            }
+            if (inserted) {
+                memcpy(value, values[j], value_size);
+            } else if (args->combine != NULL) {
+                args->combine(keys[j], value, values[j], args->context);
+            }
+        }
+        n = 0;
+    }
+    return true;
+}
+
+/*
+ * Three passes over every group of keys: prefetch the start buckets, find or insert the keys and prefetch their values,
+ * add the deltas. Keys repeated in a group get the same counter, the adds are applied in key order.
+ */
+OHA_FORCE_INLINE size_t add_u64_batch_impl(struct oha_lpht * table,
+                                           const void * keys,
+                                           const uint64_t * deltas,
+                                           size_t count,
+                                           size_t key_size,
+                                           bool custom_hash,
+                                           bool filter)
+{
+    uint64_t hashes[BATCH_GROUP_SIZE];
+    uint64_t * counters[BATCH_GROUP_SIZE];
+    bool inserted[BATCH_GROUP_SIZE];
+    for (size_t start = 0; start < count; start += BATCH_GROUP_SIZE) {
+        size_t n = MIN(BATCH_GROUP_SIZE, count - start);
+        const uint8_t * group_keys = (const uint8_t *)keys + start * key_size;
+
+        hash_keys(table, group_keys, n, hashes, key_size, custom_hash);
+        for (size_t i = 0; i < n; i++) {
+            __builtin_prefetch(get_start_bucket(table, hashes[i]), 1);
+        }
+        bool full = false;
+        for (size_t i = 0; i < n; i++) {
+            inserted[i] = false;
+            counters[i] = insert_hashed_impl(table, group_keys + i * key_size, hashes[i], &inserted[i], key_size, filter);
+            if (counters[i] == NULL) {
+                n = i;
+                full = true;
+                break;
+            }
+            __builtin_prefetch(counters[i], 1);
+        }
+        for (size_t i = 0; i < n; i++) {
+            uint64_t delta = deltas == NULL ? 1 : deltas[start + i];
+            *counters[i] = inserted[i] ? delta : *counters[i] + delta;
+        }
+        if (full) {
+            return start + n;
+        }
+    }
+    return count;
+}
+
+OHA_FORCE_INLINE void *
+remove_impl(struct oha_lpht * table, const void * key, size_t key_size, bool custom_hash, bool filter)
+{
+    uint64_t hash = hash_key(table, key, key_size, custom_hash);
 
     // 1. find the bucket to the given key
     struct key_bucket * bucket_to_remove = NULL;
     struct key_bucket * current = get_start_bucket(table, hash);
-    while (current->is_occupied) {
-        if (MEMCMP_KEY(current->key_buffer, key, table->storage.key_size) == 0) {
+    for (size_t offset = 0; current->is_occupied && offset < table->max_probe; offset++) {
+        STATS_INC(table, probe_steps);
+        if (keys_equal(table, current, key, hash, key_size)) {
             bucket_to_remove = current;
             break;
         }
         current = get_next_bucket(table, current);
     }
-    // key not found
     if (bucket_to_remove == NULL) {
-        return NULL;
+        int slot = table->stash_used != 0 ? find_in_stash(table, key, hash, key_size) : -1;
+        // key not found
+        if (slot < 0) {
+            return NULL;
+        }
+        // stash buckets have no collisions to move
+        free_stash_slot(table, slot);
+        table->elems--;
+        if (filter) {
+            add_filter_stale_keys(table, 1);
+        }
+        return get_value(get_stash_bucket(table, slot));
     }
 
     // 2. find the last collision regarding this bucket
     struct key_bucket * collision = NULL;
-    uint_fast32_t start_offset = bucket_to_remove->offset;
-    uint_fast32_t i = 0;
+    size_t start_offset = bucket_to_remove->offset;
+    size_t i = 0;
     current = get_next_bucket(table, current);
     do {
         i++;
+        STATS_INC(table, probe_steps);
         if (current->offset == start_offset + i) {
             collision = current;
             break; // disable this to search the last collision, twice iterations vs. memcpy
@@ -384,22 +855,772 @@ void * oha_lpht_remove(struct oha_lpht * table, const void * key)
     void * value = get_value(bucket_to_remove);
     if (collision != NULL) {
         // copy collision to the element to remove
-        swap_bucket_values(bucket_to_remove, collision);
-        MEMCPY_KEY(bucket_to_remove->key_buffer, collision->key_buffer, table->storage.key_size);
+        swap_bucket_values(table, bucket_to_remove, collision);
+        move_key(table, bucket_to_remove, collision, key_size);
         collision->is_occupied = 0;
         collision->offset = 0;
-        probify(table, collision, 0);
+        probify(table, collision, 0, key_size);
     } else {
         // simple deletion
         bucket_to_remove->is_occupied = 0;
         bucket_to_remove->offset = 0;
-        probify(table, bucket_to_remove, 0);
+        probify(table, bucket_to_remove, 0, key_size);
     }
 
     table->elems--;
+    if (filter) {
+        add_filter_stale_keys(table, 1);
+    }
     return value;
 }
 
+#define DEFINE_KERNELS(name, key_size, custom_hash, filter)                                                            \
+    static void * look_up_##name(struct oha_lpht * table, const void * key)                                            \
+    {                                                                                                                  \
+        return look_up_impl(table, key, key_size, custom_hash, filter);                                                \
+    }                                                                                                                  \
+    static void * insert_##name(struct oha_lpht * table, const void * key, bool * inserted)                            \
+    {                                                                                                                  \
+        return insert_impl(table, key, inserted, key_size, custom_hash, filter);                                       \
+    }                                                                                                                  \
+    static void * prepare_insert_##name(struct oha_lpht * table, const void * key, struct oha_lpht_slot * slot)        \
+    {                                                                                                                  \
+        return prepare_insert_impl(table, key, slot, key_size, custom_hash);                                           \
+    }                                                                                                                  \
+    static void * remove_##name(struct oha_lpht * table, const void * key)                                             \
+    {                                                                                                                  \
+        return remove_impl(table, key, key_size, custom_hash, filter);                                                 \
+    }                                                                                                                  \
+    static void look_up_batch_##name(struct oha_lpht * table, const void * keys, size_t count, void ** values)         \
+    {                                                                                                                  \
+        look_up_batch_impl(table, keys, count, values, key_size, custom_hash, filter);                                 \
+    }                                                                                                                  \
+    static const void * probe_init_##name(struct oha_lpht * table, struct oha_lpht_probe * probe, const void * key)    \
+    {                                                                                                                  \
+        return probe_init_impl(table, probe, key, key_size, custom_hash);                                              \
+    }                                                                                                                  \
+    static bool probe_step_##name(struct oha_lpht * table, struct oha_lpht_probe * probe, void ** value)               \
+    {                                                                                                                  \
+        return probe_step_impl(table, probe, value, key_size);                                                         \
+    }                                                                                                                  \
+    static bool merge_##name(struct oha_lpht * table, struct oha_lpht * src, const struct merge_args * args)           \
+    {                                                                                                                  \
+        return merge_impl(table, src, args, key_size, custom_hash, filter);                                            \
+    }                                                                                                                  \
+    static size_t add_u64_batch_##name(                                                                                \
+        struct oha_lpht * table, const void * keys, const uint64_t * deltas, size_t count)                             \
+    {                                                                                                                  \
+        return add_u64_batch_impl(table, keys, deltas, count, key_size, custom_hash, filter);                          \
+    }                                                                                                                  \
+    static const struct lpht_kernels kernels_##name = {                                                                \
+        .look_up = look_up_##name,                                                                                     \
+        .insert = insert_##name,                                                                                       \
+        .prepare_insert = prepare_insert_##name,                                                                       \
+        .remove = remove_##name,                                                                                       \
+        .look_up_batch = look_up_batch_##name,                                                                         \
+        .probe_init = probe_init_##name,                                                                               \
+        .probe_step = probe_step_##name,                                                                               \
+        .merge = merge_##name,                                                                                         \
+        .add_u64_batch = add_u64_batch_##name,                                                                         \
+    };
+
+// every kernel exists with and without the filter check, tables without filter pay nothing for it
+#define DEFINE_KERNEL_PAIR(name, key_size, custom_hash)                                                                \
+    DEFINE_KERNELS(name, key_size, custom_hash, false)                                                                 \
+    DEFINE_KERNELS(name##_filter, key_size, custom_hash, true)
+
+#define PICK_KERNELS(name, filter) ((filter) ? &kernels_##name##_filter : &kernels_##name)
+
+#ifdef OHA_FIX_KEY_SIZE_IN_BYTES
+DEFINE_KERNEL_PAIR(fix, OHA_FIX_KEY_SIZE_IN_BYTES, false)
+DEFINE_KERNEL_PAIR(custom_hash, OHA_FIX_KEY_SIZE_IN_BYTES, true)
+#else
+DEFINE_KERNEL_PAIR(4, 4, false)
+DEFINE_KERNEL_PAIR(8, 8, false)
+DEFINE_KERNEL_PAIR(16, 16, false)
+DEFINE_KERNEL_PAIR(32, 32, false)
+DEFINE_KERNEL_PAIR(generic, table->storage.key_size, false)
+DEFINE_KERNEL_PAIR(custom_hash, table->storage.key_size, true)
+#endif
+
+static const struct lpht_kernels * select_kernels(size_t key_size, bool custom_hash, bool filter)
+{
+    if (custom_hash) {
+        return PICK_KERNELS(custom_hash, filter);
+    }
+#ifdef OHA_FIX_KEY_SIZE_IN_BYTES
+    (void)key_size;
+    return PICK_KERNELS(fix, filter);
+#else
+    switch (key_size) {
+        case 4:
+            return PICK_KERNELS(4, filter);
+        case 8:
+            return PICK_KERNELS(8, filter);
+        case 16:
+            return PICK_KERNELS(16, filter);
+        case 32:
+            return PICK_KERNELS(32, filter);
+        default:
+            return PICK_KERNELS(generic, filter);
+    }
+#endif
+}
+
+static int get_storage_values(const struct oha_lpht_config * config, struct storage_info * values)
+{
+    if (config == NULL || values == NULL) {
+        return EINVAL;
+    }
+
+    // TODO support zero value size as hash set
+    if (config->max_elems == 0 || config->value_size == 0 || config->load_factor <= 0.0 || config->load_factor >= 1.0) {
+        return EINVAL;
+    }
+    if (config->filter_bits_per_elem > FILTER_MAX_BITS_PER_ELEM) {
+        return EINVAL;
+    }
+    // the shrunk table is half full, higher thresholds would shrink it again and again
+    if (config->shrink_threshold < 0.0 || config->shrink_threshold >= 0.5) {
+        return EINVAL;
+    }
+
+#ifndef OHA_FIX_KEY_SIZE_IN_BYTES
+    if (config->key_size == 0) {
+        return EINVAL;
+    }
+    values->key_size = config->key_size;
+#else
+    values->key_size = OHA_FIX_KEY_SIZE_IN_BYTES;
+#endif
+
+    // the bucket offsets limit the number of buckets
+    double max_indicies = ceil((1 / config->load_factor) * config->max_elems) + 1;
+    if (max_indicies >= (double)MAX_INDICIES || max_indicies >= (double)SIZE_MAX) {
+        return EINVAL;
+    }
+    values->max_indicies = max_indicies;
+    values->stash_size = config->max_probe > 0 ? STASH_SIZE : 0;
+    values->key_from_value = config->key_from_value;
+    values->value_size = (values->key_from_value ? sizeof(struct value_bucket) : 0) + add_alignment(config->value_size);
+    values->key_bucket_size = add_alignment(sizeof(struct key_bucket) + values->key_size);
+    values->hash_offset = 0;
+    if (config->cache_hashes) {
+        // the hash is placed 8 byte aligned behind the key buffer
+        values->hash_offset = (sizeof(struct key_bucket) + values->key_size + 7) & ~(size_t)7;
+        values->key_bucket_size = values->hash_offset + sizeof(uint64_t);
+    }
+
+    size_t filter_bits;
+    if (!oha_mul_size(config->filter_bits_per_elem, config->max_elems, &filter_bits)) {
+        return EINVAL;
+    }
+    values->filter_blocks = filter_bits / (8 * sizeof(struct filter_block)) +
+                            (filter_bits % (8 * sizeof(struct filter_block)) != 0);
+
+    // table space + keys + values + aligned stash hashes + cache line aligned filter
+    const size_t num_buckets = values->max_indicies + values->stash_size;
+    size_t keys_size;
+    size_t values_size;
+    size_t size = sizeof(struct oha_lpht);
+    if (!oha_mul_size(values->key_bucket_size, num_buckets, &keys_size) ||
+        !oha_mul_size(values->value_size, num_buckets, &values_size) || !oha_add_size(size, keys_size, &size) ||
+        !oha_add_size(size, values_size, &size)) {
+        return EINVAL;
+    }
+    if (values->stash_size > 0 && !oha_add_size(size, sizeof(uint64_t) * (values->stash_size + 1), &size)) {
+        return EINVAL;
+    }
+    if (values->filter_blocks > 0) {
+        size_t filter_size;
+        if (!oha_mul_size(sizeof(struct filter_block), values->filter_blocks, &filter_size) ||
+            !oha_add_size(size, filter_size, &size) || !oha_add_size(size, CACHE_LINE_SIZE, &size)) {
+            return EINVAL;
+        }
+    }
+    values->hash_table_size = size;
+
+    return 0;
+}
+
+static struct oha_lpht * init_table_value(const struct oha_lpht_config * config,
+                                          const struct storage_info * storage,
+                                          struct oha_lpht * table)
+{
+    table->kernels = select_kernels(storage->key_size, config->hash_fn != NULL, storage->filter_blocks > 0);
+    table->hash_fn = config->hash_fn;
+    table->seed = config->seed == 0 ? XXHASH_SEED : config->seed;
+    table->storage = *storage;
+    table->memory = config->memory;
+    table->config = *config;
+    table->key_buckets = move_ptr_num_bytes(table, sizeof(struct oha_lpht));
+    table->last_key_bucket =
+        move_ptr_num_bytes(table->key_buckets, table->storage.key_bucket_size * (table->storage.max_indicies - 1));
+    // the stash buckets follow the last bucket, the probe sequences wrap around before them
+    table->value_buckets =
+        move_ptr_num_bytes(table->key_buckets, table->storage.key_bucket_size * get_num_buckets(table));
+    table->max_elems = config->max_elems;
+    table->current_bucket_to_clear = NULL;
+    table->clear_mode_on = false;
+    table->filter = NULL;
+    table->filter_stale_keys = 0;
+    // a new seed does not change custom hashes, so they are not monitored
+    table->reseed_probe_length =
+        config->reseed_probe_length == 0 || config->hash_fn != NULL ? SIZE_MAX : config->reseed_probe_length;
+    table->reseed_pending = false;
+    table->max_probe = config->max_probe == 0 ? SIZE_MAX : config->max_probe;
+    table->max_offset = 0;
+    table->stash_used = 0;
+    table->stash_hashes = NULL;
+    table->owns_memory = false;
+    void * end = move_ptr_num_bytes(table->value_buckets, storage->value_size * get_num_buckets(table));
+    if (storage->stash_size > 0) {
+        uintptr_t hashes = ((uintptr_t)end + sizeof(uint64_t) - 1) & ~(uintptr_t)(sizeof(uint64_t) - 1);
+        table->stash_hashes = (uint64_t *)hashes;
+        end = table->stash_hashes + storage->stash_size;
+    }
+    if (storage->filter_blocks > 0) {
+        table->filter = align_ptr_cache_line(end);
+        memset(table->filter, 0, sizeof(struct filter_block) * storage->filter_blocks);
+    }
+#ifdef OHA_WITH_STATS
+    memset(&table->statistics, 0, sizeof(table->statistics));
+#endif
+
+    // connect hash buckets and value buckets
+    struct key_bucket * current_key_bucket = table->key_buckets;
+    void * current_value_bucket = table->value_buckets;
+    for (size_t i = 0; i < get_num_buckets(table); i++) {
+        if (table->storage.key_from_value) {
+            struct value_bucket * value_bucket = current_value_bucket;
+            value_bucket->key = current_key_bucket;
+            current_key_bucket->value = value_bucket->value_buffer;
+        } else {
+            current_key_bucket->value = current_value_bucket;
+        }
+        current_key_bucket = move_ptr_num_bytes(current_key_bucket, table->storage.key_bucket_size);
+        current_value_bucket = get_next_value(table, current_value_bucket);
+    }
+    return table;
+}
+
+/*
+ * public functions
+ */
+
+void oha_lpht_destroy(struct oha_lpht * table)
+{
+    if (table == NULL) {
+        return;
+    }
+    struct oha_memory_fp memory = table->memory;
+    oha_free(&memory, table);
+}
+
+size_t oha_lpht_calculate_size(const struct oha_lpht_config * config)
+{
+    struct storage_info storage;
+    if (get_storage_values(config, &storage) != 0) {
+        return 0;
+    }
+    return storage.hash_table_size;
+}
+
+struct oha_lpht * oha_lpht_initialize(const struct oha_lpht_config * config, void * memory)
+{
+    struct oha_lpht * table = memory;
+    if (table == NULL) {
+        return NULL;
+    }
+    struct storage_info storage;
+    if (get_storage_values(config, &storage) != 0) {
+        return NULL;
+    }
+    return init_table_value(config, &storage, table);
+}
+
+struct oha_lpht * oha_lpht_create(const struct oha_lpht_config * config)
+{
+    struct storage_info storage;
+    if (get_storage_values(config, &storage) != 0) {
+        return NULL;
+    }
+    struct oha_lpht * table = oha_calloc(&config->memory, storage.hash_table_size);
+    if (table == NULL) {
+        return NULL;
+    }
+    init_table_value(config, &storage, table);
+    table->owns_memory = true;
+    return table;
+}
+
+static inline void * rebase_ptr(void * ptr, ptrdiff_t delta)
+{
+    return (uint8_t *)ptr + delta;
+}
+
+/*
+ * The table is one memory block, so a memcpy copies all elements. Only the pointers into the block have to be moved
+ * by the distance of both blocks afterwards.
+ */
+struct oha_lpht * oha_lpht_clone(const struct oha_lpht * src, void * dst_memory)
+{
+    if (src == NULL) {
+        return NULL;
+    }
+    struct oha_lpht * table = dst_memory;
+    if (table == NULL) {
+        table = oha_calloc(&src->memory, src->storage.hash_table_size);
+        if (table == NULL) {
+            return NULL;
+        }
+    }
+    memcpy(table, src, src->storage.hash_table_size);
+    if (dst_memory != NULL) {
+        // the caller owns dst_memory, the allocator of src must never release it
+        table->memory = (struct oha_memory_fp){0};
+        table->owns_memory = false;
+    } else {
+        table->owns_memory = true;
+    }
+
+    const ptrdiff_t delta = (uint8_t *)table - (const uint8_t *)src;
+    table->key_buckets = rebase_ptr(table->key_buckets, delta);
+    table->last_key_bucket = rebase_ptr(table->last_key_bucket, delta);
+    table->value_buckets = rebase_ptr(table->value_buckets, delta);
+    if (table->filter != NULL) {
+        table->filter = rebase_ptr(table->filter, delta);
+    }
+    if (table->stash_hashes != NULL) {
+        table->stash_hashes = rebase_ptr(table->stash_hashes, delta);
+    }
+    if (table->current_bucket_to_clear != NULL) {
+        table->current_bucket_to_clear = rebase_ptr(table->current_bucket_to_clear, delta);
+    }
+
+    // plain loops over the bucket and value arrays without other dependencies
+    const size_t max_indicies = get_num_buckets(table);
+    uint8_t * key_bucket = (uint8_t *)table->key_buckets;
+    for (size_t i = 0; i < max_indicies; i++) {
+        struct key_bucket * bucket = (struct key_bucket *)(key_bucket + i * table->storage.key_bucket_size);
+        bucket->value = rebase_ptr(bucket->value, delta);
+    }
+    if (table->storage.key_from_value) {
+        uint8_t * value_bucket = table->value_buckets;
+        for (size_t i = 0; i < max_indicies; i++) {
+            struct value_bucket * bucket = (struct value_bucket *)(value_bucket + i * table->storage.value_size);
+            bucket->key = rebase_ptr(bucket->key, delta);
+        }
+    }
+    return table;
+}
+
+/*
+ * The table is one memory block, so the elements are moved into a new table with the merge kernel. Tables are never
+ * resized in place, the block would keep its old size.
+ */
+static struct oha_lpht * rehash(struct oha_lpht * table, const struct oha_lpht_config * config)
+{
+    // memory of the caller (oha_lpht_initialize(), clones into dst_memory) must not be released
+    if (!table->owns_memory || table->clear_mode_on || config->max_elems < table->elems) {
+        return NULL;
+    }
+    struct oha_lpht * new_table = oha_lpht_create(config);
+    if (new_table == NULL) {
+        return NULL;
+    }
+    const struct merge_args args = {0};
+    if (!new_table->kernels->merge(new_table, table, &args)) {
+        oha_lpht_destroy(new_table);
+        return NULL;
+    }
+#ifdef OHA_WITH_STATS
+    new_table->statistics = table->statistics;
+#endif
+    oha_lpht_destroy(table);
+    return new_table;
+}
+
+// nonzero seed from the kernel, falls back to the clock and the table address
+static uint64_t get_random_seed(const struct oha_lpht * table)
+{
+    uint64_t seed = 0;
+#ifdef __linux__
+    if (getrandom(&seed, sizeof(seed), GRND_NONBLOCK) == sizeof(seed) && seed != 0) {
+        return seed;
+    }
+#endif
+    const uint64_t entropy[] = {(uint64_t)time(NULL), (uint64_t)clock(), (uint64_t)(uintptr_t)table};
+    return XXH64(entropy, sizeof(entropy), table->seed) | 1;
+}
+
+struct oha_lpht * oha_lpht_rehash(struct oha_lpht * table, oha_capacity_t new_max_elems, double new_load_factor)
+{
+    if (table == NULL) {
+        return NULL;
+    }
+    struct oha_lpht_config config = table->config;
+    config.max_elems = new_max_elems;
+    if (new_load_factor != 0.0) {
+        config.load_factor = new_load_factor;
+    }
+    return rehash(table, &config);
+}
+
+struct oha_lpht * oha_lpht_auto_shrink(struct oha_lpht * table)
+{
+    if (table == NULL || table->config.shrink_threshold == 0.0) {
+        return table;
+    }
+    if (table->elems >= table->config.shrink_threshold * table->max_elems) {
+        return table;
+    }
+    struct oha_lpht * shrunk = oha_lpht_rehash(table, MAX(2 * table->elems, 1), 0.0);
+    return shrunk == NULL ? table : shrunk;
+}
+
+/*
+ * Long probes under a random seed are caused by the load and not by the keys, so the new table starts unmarked and
+ * is only reseeded again, if its own inserts exceed the limit.
+ */
+struct oha_lpht * oha_lpht_auto_reseed(struct oha_lpht * table)
+{
+    // like rehash(), memory of the caller is never released and the table stays marked
+    if (table == NULL || !table->reseed_pending || !table->owns_memory) {
+        return table;
+    }
+    struct oha_lpht_config config = table->config;
+    config.seed = get_random_seed(table);
+    struct oha_lpht * reseeded = rehash(table, &config);
+    if (reseeded == NULL) {
+        return table;
+    }
+    reseeded->reseed_pending = false;
+    STATS_INC(reseeded, reseeds);
+    return reseeded;
+}
+
+// return pointer to value
+void * oha_lpht_look_up(struct oha_lpht * table, const void * key)
+{
+    if (table == NULL || key == NULL) {
+        return NULL;
+    }
+    return table->kernels->look_up(table, key);
+}
+
+void oha_lpht_look_up_batch(struct oha_lpht * table, const void * keys, size_t count, void ** values)
+{
+    if (table == NULL || keys == NULL || values == NULL) {
+        return;
+    }
+    table->kernels->look_up_batch(table, keys, count, values);
+}
+
+const void * oha_lpht_probe_init(struct oha_lpht * table, struct oha_lpht_probe * probe, const void * key)
+{
+    if (table == NULL || probe == NULL || key == NULL) {
+        return NULL;
+    }
+    return table->kernels->probe_init(table, probe, key);
+}
+
+bool oha_lpht_probe_step(struct oha_lpht * table, struct oha_lpht_probe * probe, void ** value)
+{
+    if (table == NULL || probe == NULL || value == NULL) {
+        return true;
+    }
+    return table->kernels->probe_step(table, probe, value);
+}
+
+void * oha_lpht_prepare_insert(struct oha_lpht * table, const void * key, struct oha_lpht_slot * slot)
+{
+    if (slot != NULL) {
+        slot->bucket = NULL;
+    }
+    if (table == NULL || key == NULL || slot == NULL) {
+        return NULL;
+    }
+    return table->kernels->prepare_insert(table, key, slot);
+}
+
+void * oha_lpht_commit_insert(struct oha_lpht * table, struct oha_lpht_slot * slot)
+{
+    if (table == NULL || slot == NULL || slot->bucket == NULL) {
+        return NULL;
+    }
+    return table->filter != NULL ? commit_insert_impl(table, slot, true) : commit_insert_impl(table, slot, false);
+}
+
+void oha_lpht_abort_insert(struct oha_lpht * table, struct oha_lpht_slot * slot)
+{
+    (void)table;
+    // the reserved bucket was never marked as occupied
+    if (slot != NULL) {
+        slot->bucket = NULL;
+    }
+}
+
+// return pointer to value
+void * oha_lpht_insert(struct oha_lpht * table, const void * key)
+{
+    bool inserted;
+    return oha_lpht_insert_ex(table, key, &inserted);
+}
+
+// return pointer to value, inserted is set to true if the key was not in the table before
+void * oha_lpht_insert_ex(struct oha_lpht * table, const void * key, bool * inserted)
+{
+    if (inserted != NULL) {
+        *inserted = false;
+    }
+    if (table == NULL || key == NULL || inserted == NULL) {
+        return NULL;
+    }
+    return table->kernels->insert(table, key, inserted);
+}
+
+uint64_t * oha_lpht_add_u64(struct oha_lpht * table, const void * key, uint64_t delta)
+{
+    if (table == NULL || key == NULL || table->config.value_size != sizeof(uint64_t)) {
+        return NULL;
+    }
+    bool inserted = false;
+    uint64_t * counter = table->kernels->insert(table, key, &inserted);
+    if (counter != NULL) {
+        *counter = inserted ? delta : *counter + delta;
+    }
+    return counter;
+}
+
+size_t oha_lpht_add_u64_batch(struct oha_lpht * table, const void * keys, const uint64_t * deltas, size_t count)
+{
+    if (table == NULL || keys == NULL || table->config.value_size != sizeof(uint64_t)) {
+        return 0;
+    }
+    return table->kernels->add_u64_batch(table, keys, deltas, count);
+}
+
+void * oha_lpht_get_key_from_value(const struct oha_lpht * table, const void * value)
+{
+    // without key_from_value there is no key pointer in front of the value
+    if (table == NULL || value == NULL || !table->storage.key_from_value) {
+        return NULL;
+    }
+    struct value_bucket * value_bucket = get_value_bucket((void *)value);
+    assert(value_bucket->key->value == value);
+    return value_bucket->key->key_buffer;
+}
+
+void oha_lpht_clear(struct oha_lpht * table)
+{
+    if (table == NULL) {
+        return;
+    }
+    if (!table->clear_mode_on) {
+        table->clear_mode_on = true;
+        table->current_bucket_to_clear = table->key_buckets;
+    }
+}
+
+struct oha_key_value_pair oha_lpht_get_next_element_to_remove(struct oha_lpht * table)
+{
+    struct oha_key_value_pair pair = {0};
+    if (table == NULL || !table->clear_mode_on) {
+        return pair;
+    }
+    bool stop = false;
+
+    struct key_bucket * end = get_bucket(table, get_num_buckets(table));
+    while (table->current_bucket_to_clear < end) {
+        if (table->current_bucket_to_clear->is_occupied) {
+            pair.value = get_value(table->current_bucket_to_clear);
+            pair.key = table->current_bucket_to_clear->key_buffer;
+            stop = true;
+        }
+        table->current_bucket_to_clear =
+            move_ptr_num_bytes(table->current_bucket_to_clear, table->storage.key_bucket_size);
+        if (stop == true) {
+            break;
+        }
+    }
+
+    return pair;
+}
+
+struct oha_key_value_pair oha_lpht_get_next_element(struct oha_lpht * table, size_t * position)
+{
+    struct oha_key_value_pair pair = {0};
+    if (table == NULL || position == NULL) {
+        return pair;
+    }
+    while (*position < get_num_buckets(table)) {
+        struct key_bucket * bucket = get_bucket(table, *position);
+        (*position)++;
+        if (bucket->is_occupied) {
+            pair.key = bucket->key_buffer;
+            pair.value = get_value(bucket);
+            break;
+        }
+    }
+    return pair;
+}
+
+// return pointer to the removed value, the value is valid until the next insert
+void * oha_lpht_remove(struct oha_lpht * table, const void * key)
+{
+    if (table == NULL || key == NULL) {
+        return NULL;
+    }
+    return table->kernels->remove(table, key);
+}
+
+static bool merge(struct oha_lpht * dst, struct oha_lpht * src, const struct merge_args * args)
+{
+    if (dst == NULL || src == NULL || dst == src) {
+        return false;
+    }
+    if (dst->storage.key_size != src->storage.key_size || get_user_value_size(dst) != get_user_value_size(src)) {
+        return false;
+    }
+    return dst->kernels->merge(dst, src, args);
+}
+
+bool oha_lpht_merge(struct oha_lpht * dst,
+                    struct oha_lpht * src,
+                    void (*combine)(const void * key, void * dst_value, const void * src_value, void * context),
+                    void * context)
+{
+    const struct merge_args args = {
+        .combine = combine,
+        .context = context,
+    };
+    return merge(dst, src, &args);
+}
+
+bool oha_lpht_merge_partition(struct oha_lpht * dst,
+                              struct oha_lpht * src,
+                              void (*combine)(const void * key, void * dst_value, const void * src_value, void * context),
+                              void * context,
+                              uint32_t partition,
+                              uint32_t num_partitions)
+{
+    if (num_partitions == 0 || partition >= num_partitions) {
+        return false;
+    }
+    const struct merge_args args = {
+        .combine = combine,
+        .context = context,
+        .partition = partition,
+        .num_partitions = num_partitions,
+    };
+    return merge(dst, src, &args);
+}
+
+uint32_t oha_lpht_get_partition(struct oha_lpht * table, const void * key, uint32_t num_partitions)
+{
+    if (table == NULL || key == NULL) {
+        return 0;
+    }
+    const size_t key_size = table->storage.key_size;
+    const bool custom_hash = table->hash_fn != NULL;
+    return get_key_partition(
+        table, key, hash_key(table, key, key_size, custom_hash), num_partitions, key_size, custom_hash);
+}
+
+/*
+ * Removes all elements matching the predicate in a single sweep over the bucket array. Surviving elements are moved
+ * into the holes of their cluster during the same sweep, so no backward shift per removed key is needed.
+ */
+oha_capacity_t oha_lpht_erase_if(struct oha_lpht * table,
+                                 bool (*pred)(const void * key, void * value, void * context),
+                                 void * context)
+{
+    if (table == NULL || pred == NULL) {
+        return 0;
+    }
+
+    // start the sweep behind an empty bucket, so no cluster wraps around the sweep start
+    const size_t max_indicies = table->storage.max_indicies;
+    size_t start = 0;
+    while (get_bucket(table, start)->is_occupied) {
+        start++;
+    }
+
+    oha_capacity_t erased = 0;
+    bool cluster_has_hole = false;
+    size_t first_hole = 0; // first empty bucket of the current cluster
+    for (size_t step = 1; step < max_indicies; step++) {
+        size_t index = (start + step) % max_indicies;
+        struct key_bucket * bucket = get_bucket(table, index);
+        if (!bucket->is_occupied) {
+            // end of cluster, all buckets behind are untouched so far
+            cluster_has_hole = false;
+            continue;
+        }
+
+        if (pred(bucket->key_buffer, get_value(bucket), context)) {
+            bucket->is_occupied = 0;
+            bucket->offset = 0;
+            erased++;
+            if (!cluster_has_hole) {
+                cluster_has_hole = true;
+                first_hole = index;
+            }
+            continue;
+        }
+
+        if (!cluster_has_hole) {
+            continue;
+        }
+
+        // move the survivor to the first hole behind its home bucket
+        size_t home = (index + max_indicies - bucket->offset) % max_indicies;
+        size_t target;
+        if (get_distance(table, home, first_hole) < get_distance(table, home, index)) {
+            target = first_hole;
+        } else {
+            target = home;
+            while (target != index && get_bucket(table, target)->is_occupied) {
+                target = (target + 1) % max_indicies;
+            }
+        }
+        if (target == index) {
+            continue;
+        }
+
+        struct key_bucket * target_bucket = get_bucket(table, target);
+        swap_bucket_values(table, target_bucket, bucket);
+        move_key(table, target_bucket, bucket, table->storage.key_size);
+        target_bucket->offset = get_distance(table, home, target);
+        target_bucket->is_occupied = 1;
+        bucket->is_occupied = 0;
+        bucket->offset = 0;
+
+        if (target == first_hole) {
+            // the current bucket is empty now, so the search stops at the latest there
+            while (get_bucket(table, first_hole)->is_occupied) {
+                first_hole = (first_hole + 1) % max_indicies;
+            }
+        }
+    }
+
+    // the stash buckets do not depend on each other
+    for (uint32_t slot = 0; slot < table->storage.stash_size; slot++) {
+        struct key_bucket * bucket = get_stash_bucket(table, slot);
+        if (bucket->is_occupied && pred(bucket->key_buffer, get_value(bucket), context)) {
+            free_stash_slot(table, slot);
+            erased++;
+        }
+    }
+
+    table->elems -= erased;
+    if (table->filter != NULL && erased > 0) {
+        add_filter_stale_keys(table, erased);
+    }
+    return erased;
+}
+
 bool oha_lpht_get_status(struct oha_lpht * table, struct oha_lpht_status * status)
 {
     if (table == NULL || status == NULL) {
@@ -408,6 +1629,36 @@ bool oha_lpht_get_status(struct oha_lpht * table, struct oha_lpht_status * statu
 
     status->max_elems = table->max_elems;
     status->elems_in_use = table->elems;
-    status->size_in_bytes = table->storage.value_size;
+    status->size_in_bytes = table->storage.hash_table_size;
+    status->max_probe_distance = table->max_offset;
+    status->stash_in_use = __builtin_popcount(table->stash_used);
+    status->stash_size = table->storage.stash_size;
+    return true;
+}
+
+bool oha_lpht_get_statistics(struct oha_lpht * table, struct oha_lpht_statistics * statistics)
+{
+#ifdef OHA_WITH_STATS
+    if (table == NULL || statistics == NULL) {
+        return false;
+    }
+    *statistics = table->statistics;
     return true;
+#else
+    (void)table;
+    (void)statistics;
+    return false;
+#endif
+}
+
+void oha_lpht_reset_statistics(struct oha_lpht * table)
+{
+#ifdef OHA_WITH_STATS
+    if (table == NULL) {
+        return;
+    }
+    memset(&table->statistics, 0, sizeof(table->statistics));
+#else
+    (void)table;
+#endif
 }
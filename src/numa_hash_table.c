@@ -0,0 +1,291 @@
+#ifdef __linux__
+#define _GNU_SOURCE
+#endif
+
+#include "oha.h"
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <xxhash.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "utils.h"
+
+// differs from the seed of the partitions, so the routing does not correlate with the bucket index
+#define ROUTING_SEED 0x2d358dccaa6c78a5
+#define MAX_NODES (sizeof(unsigned long) * 8)
+#define ONLINE_NODES_FILE "/sys/devices/system/node/online"
+
+// memory policies of linux/mempolicy.h, defined here to avoid the libnuma dependency
+#define OHA_MPOL_BIND 2
+#define OHA_MPOL_INTERLEAVE 3
+
+struct partition {
+    struct oha_lpht * table;
+    void * memory;
+    size_t size;
+    int node; // -1 if interleaved
+};
+
+struct oha_numa_lpht {
+    uint64_t (*hash_fn)(const void * key, size_t key_size);
+    size_t key_size;
+    uint32_t num_partitions;
+    struct partition partitions[];
+};
+
+// reads the online nodes as bit mask, e.g. "0-1,4" from sysfs
+static unsigned long get_online_nodes(void)
+{
+    unsigned long nodes = 0;
+    FILE * fp = fopen(ONLINE_NODES_FILE, "r");
+    if (fp == NULL) {
+        return 1;
+    }
+    unsigned int first;
+    unsigned int last;
+    while (fscanf(fp, "%u", &first) == 1) {
+        last = first;
+        int c = fgetc(fp);
+        if (c == '-') {
+            if (fscanf(fp, "%u", &last) != 1) {
+                break;
+            }
+            c = fgetc(fp);
+        }
+        for (unsigned int node = first; node <= last && node < MAX_NODES; node++) {
+            nodes |= 1UL << node;
+        }
+        if (c != ',') {
+            break;
+        }
+    }
+    fclose(fp);
+    return nodes == 0 ? 1 : nodes;
+}
+
+// returns the n-th set bit of the node mask
+static int get_nth_node(unsigned long nodes, uint32_t n)
+{
+    for (int node = 0; node < (int)MAX_NODES; node++) {
+        if (nodes & (1UL << node)) {
+            if (n == 0) {
+                return node;
+            }
+            n--;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Maps zeroed memory and binds it to the node mask before the first touch, so the pages are faulted on the selected
+ * nodes during the table initialization.
+ */
+static void * map_memory(size_t size, int mode, unsigned long nodes)
+{
+#ifdef __linux__
+    void * memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        return NULL;
+    }
+    // best effort, e.g. the syscall could be blocked in containers
+    (void)syscall(SYS_mbind, memory, size, mode, &nodes, MAX_NODES + 1, 0);
+    return memory;
+#else
+    (void)mode;
+    (void)nodes;
+    return calloc(1, size);
+#endif
+}
+
+static void unmap_memory(void * memory, size_t size)
+{
+#ifdef __linux__
+    munmap(memory, size);
+#else
+    (void)size;
+    free(memory);
+#endif
+}
+
+static uint32_t route_key(struct oha_numa_lpht * table, const void * key)
+{
+    uint64_t hash;
+    if (table->hash_fn != NULL) {
+        hash = table->hash_fn(key, table->key_size) * 0x9e3779b97f4a7c15;
+    } else {
+        hash = XXH64(key, table->key_size, ROUTING_SEED);
+    }
+    return ((hash >> 32) * table->num_partitions) >> 32;
+}
+
+/*
+ * public functions
+ */
+
+uint32_t oha_numa_get_num_nodes(void)
+{
+    return __builtin_popcountl(get_online_nodes());
+}
+
+struct oha_numa_lpht * oha_numa_lpht_create(const struct oha_numa_config * config)
+{
+    if (config == NULL) {
+        return NULL;
+    }
+    if (config->policy != OHA_NUMA_PARTITIONED && config->policy != OHA_NUMA_INTERLEAVED) {
+        return NULL;
+    }
+
+    unsigned long nodes = get_online_nodes();
+    uint32_t num_nodes = __builtin_popcountl(nodes);
+    uint32_t num_partitions = config->partitions == 0 ? num_nodes : config->partitions;
+    if (config->table.max_elems < num_partitions) {
+        return NULL;
+    }
+
+    struct oha_lpht_config partition_config = config->table;
+    partition_config.max_elems = get_partition_max_elems(config->table.max_elems, num_partitions);
+    partition_config.memory = (struct oha_memory_fp){0};
+    size_t size = oha_lpht_calculate_size(&partition_config);
+    if (size == 0) {
+        return NULL;
+    }
+
+    struct oha_numa_lpht * table =
+        calloc(1, sizeof(struct oha_numa_lpht) + sizeof(struct partition) * (size_t)num_partitions);
+    if (table == NULL) {
+        return NULL;
+    }
+    table->hash_fn = config->table.hash_fn;
+#ifdef OHA_FIX_KEY_SIZE_IN_BYTES
+    table->key_size = OHA_FIX_KEY_SIZE_IN_BYTES;
+#else
+    table->key_size = config->table.key_size;
+#endif
+    table->num_partitions = num_partitions;
+
+    for (uint32_t i = 0; i < num_partitions; i++) {
+        struct partition * partition = &table->partitions[i];
+        void * memory;
+        if (config->policy == OHA_NUMA_INTERLEAVED) {
+            partition->node = -1;
+            memory = map_memory(size, OHA_MPOL_INTERLEAVE, nodes);
+        } else {
+            partition->node = get_nth_node(nodes, i % num_nodes);
+            memory = map_memory(size, OHA_MPOL_BIND, 1UL << partition->node);
+        }
+        if (memory == NULL) {
+            oha_numa_lpht_destroy(table);
+            return NULL;
+        }
+        partition->memory = memory;
+        partition->size = size;
+        partition->table = oha_lpht_initialize(&partition_config, memory);
+    }
+    return table;
+}
+
+void oha_numa_lpht_destroy(struct oha_numa_lpht * table)
+{
+    if (table == NULL) {
+        return;
+    }
+    for (uint32_t i = 0; i < table->num_partitions; i++) {
+        if (table->partitions[i].memory != NULL) {
+            unmap_memory(table->partitions[i].memory, table->partitions[i].size);
+        }
+    }
+    free(table);
+}
+
+void * oha_numa_lpht_look_up(struct oha_numa_lpht * table, const void * key)
+{
+    if (table == NULL || key == NULL) {
+        return NULL;
+    }
+    return oha_lpht_look_up(table->partitions[route_key(table, key)].table, key);
+}
+
+void * oha_numa_lpht_insert(struct oha_numa_lpht * table, const void * key)
+{
+    bool inserted;
+    return oha_numa_lpht_insert_ex(table, key, &inserted);
+}
+
+void * oha_numa_lpht_insert_ex(struct oha_numa_lpht * table, const void * key, bool * inserted)
+{
+    if (inserted != NULL) {
+        *inserted = false;
+    }
+    if (table == NULL || key == NULL) {
+        return NULL;
+    }
+    return oha_lpht_insert_ex(table->partitions[route_key(table, key)].table, key, inserted);
+}
+
+void * oha_numa_lpht_remove(struct oha_numa_lpht * table, const void * key)
+{
+    if (table == NULL || key == NULL) {
+        return NULL;
+    }
+    return oha_lpht_remove(table->partitions[route_key(table, key)].table, key);
+}
+
+uint32_t oha_numa_lpht_get_num_partitions(struct oha_numa_lpht * table)
+{
+    return table == NULL ? 0 : table->num_partitions;
+}
+
+uint32_t oha_numa_lpht_get_partition(struct oha_numa_lpht * table, const void * key)
+{
+    if (table == NULL || key == NULL) {
+        return 0;
+    }
+    return route_key(table, key);
+}
+
+int oha_numa_lpht_get_partition_node(struct oha_numa_lpht * table, uint32_t partition)
+{
+    if (table == NULL || partition >= table->num_partitions) {
+        return -1;
+    }
+    return table->partitions[partition].node;
+}
+
+struct oha_lpht * oha_numa_lpht_get_partition_table(struct oha_numa_lpht * table, uint32_t partition)
+{
+    if (table == NULL || partition >= table->num_partitions) {
+        return NULL;
+    }
+    return table->partitions[partition].table;
+}
+
+bool oha_numa_lpht_get_status(struct oha_numa_lpht * table, struct oha_lpht_status * status)
+{
+    if (table == NULL || status == NULL) {
+        return false;
+    }
+    memset(status, 0, sizeof(*status));
+    for (uint32_t i = 0; i < table->num_partitions; i++) {
+        struct oha_lpht_status partition_status;
+        oha_lpht_get_status(table->partitions[i].table, &partition_status);
+        status->max_elems += partition_status.max_elems;
+        status->elems_in_use += partition_status.elems_in_use;
+        status->size_in_bytes += table->partitions[i].size;
+        status->max_probe_distance = MAX(status->max_probe_distance, partition_status.max_probe_distance);
+        status->stash_in_use += partition_status.stash_in_use;
+        status->stash_size += partition_status.stash_size;
+    }
+    return true;
+}
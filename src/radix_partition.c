@@ -0,0 +1,296 @@
+#include "oha.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+
+#define MAX_RADIX_BITS 14
+#define TARGET_TABLE_SIZE (256 * 1024) // fits into the L2 cache of most cores
+
+/*
+ * The rows of all partitions are stored in two arrays, partition i owns the rows [offsets[i], offsets[i + 1]). The
+ * write combining buffers collect one cache line of keys and values per partition, before they are copied to the
+ * arrays, so the scatter writes whole cache lines instead of touching 2^radix_bits lines per few rows.
+ */
+struct oha_rp {
+    struct oha_memory_fp memory;
+    size_t key_size;
+    size_t value_size;
+    uint32_t num_partitions;
+    uint32_t radix_bits;
+    size_t buffer_rows; // rows per write combining buffer
+
+    // partition tables in one memory block
+    void * tables_memory;
+    struct oha_lpht ** tables;
+
+    // rows of the last oha_rp_partition() call
+    size_t rows_capacity;
+    size_t values_capacity; // the values are only allocated by calls with values
+    bool has_values;
+    uint8_t * keys;
+    uint8_t * values;
+    uint16_t * row_partitions; // partition of every input row, the rows are hashed only once
+    size_t * offsets;
+
+    // write combining buffers, cache line aligned
+    void * buffers_memory;
+    uint8_t * key_buffers;
+    uint8_t * value_buffers;
+    size_t * buffer_fill;
+};
+
+static uint32_t select_radix_bits(const struct oha_lpht_config * config)
+{
+    size_t size = oha_lpht_calculate_size(config);
+    uint32_t radix_bits = 0;
+    while (radix_bits < MAX_RADIX_BITS && (size >> radix_bits) > TARGET_TABLE_SIZE) {
+        radix_bits++;
+    }
+    return radix_bits;
+}
+
+static bool create_tables(struct oha_rp * rp, const struct oha_lpht_config * config)
+{
+    struct oha_lpht_config partition_config = *config;
+    partition_config.max_elems = get_partition_max_elems(config->max_elems, rp->num_partitions);
+    const size_t table_size = align_cache_line(oha_lpht_calculate_size(&partition_config));
+    // the partition tables are not released one by one
+    partition_config.memory = (struct oha_memory_fp){0};
+
+    size_t size;
+    if (table_size == 0 || !oha_mul_size(table_size, rp->num_partitions, &size) ||
+        !oha_add_size(size, CACHE_LINE_SIZE, &size)) {
+        return false;
+    }
+    rp->tables_memory = oha_calloc(&rp->memory, size);
+    rp->tables = oha_calloc(&rp->memory, sizeof(struct oha_lpht *) * rp->num_partitions);
+    if (rp->tables_memory == NULL || rp->tables == NULL) {
+        return false;
+    }
+    uint8_t * memory = align_ptr_cache_line(rp->tables_memory);
+    for (uint32_t i = 0; i < rp->num_partitions; i++) {
+        rp->tables[i] = oha_lpht_initialize(&partition_config, memory + i * table_size);
+    }
+    return true;
+}
+
+static bool create_buffers(struct oha_rp * rp)
+{
+    rp->buffer_rows = MAX(CACHE_LINE_SIZE / MAX(rp->key_size, rp->value_size), 1);
+    const size_t key_buffer_size = align_cache_line(rp->buffer_rows * rp->key_size);
+    const size_t value_buffer_size = align_cache_line(rp->buffer_rows * rp->value_size);
+    size_t size = (key_buffer_size + value_buffer_size) * rp->num_partitions + CACHE_LINE_SIZE;
+    rp->buffers_memory = oha_calloc(&rp->memory, size);
+    rp->buffer_fill = oha_calloc(&rp->memory, sizeof(size_t) * rp->num_partitions);
+    rp->offsets = oha_calloc(&rp->memory, sizeof(size_t) * (rp->num_partitions + 1));
+    if (rp->buffers_memory == NULL || rp->buffer_fill == NULL || rp->offsets == NULL) {
+        return false;
+    }
+    rp->key_buffers = align_ptr_cache_line(rp->buffers_memory);
+    rp->value_buffers = rp->key_buffers + key_buffer_size * rp->num_partitions;
+    return true;
+}
+
+static void free_values(struct oha_rp * rp)
+{
+    oha_free(&rp->memory, rp->values);
+    rp->values = NULL;
+    rp->values_capacity = 0;
+}
+
+static void free_rows(struct oha_rp * rp)
+{
+    oha_free(&rp->memory, rp->keys);
+    oha_free(&rp->memory, rp->row_partitions);
+    rp->keys = NULL;
+    rp->row_partitions = NULL;
+    rp->rows_capacity = 0;
+    free_values(rp);
+}
+
+static bool reserve_values(struct oha_rp * rp, size_t count)
+{
+    if (count <= rp->values_capacity) {
+        return true;
+    }
+    free_values(rp);
+    size_t values_size;
+    if (!oha_mul_size(rp->value_size, count, &values_size)) {
+        return false;
+    }
+    rp->values = oha_calloc(&rp->memory, values_size);
+    if (rp->values == NULL) {
+        return false;
+    }
+    rp->values_capacity = count;
+    return true;
+}
+
+static bool reserve_rows(struct oha_rp * rp, size_t count, bool with_values)
+{
+    if (count > rp->rows_capacity) {
+        free_rows(rp);
+        size_t keys_size;
+        size_t partitions_size;
+        if (!oha_mul_size(rp->key_size, count, &keys_size) ||
+            !oha_mul_size(sizeof(uint16_t), count, &partitions_size)) {
+            return false;
+        }
+        rp->keys = oha_calloc(&rp->memory, keys_size);
+        rp->row_partitions = oha_calloc(&rp->memory, partitions_size);
+        if (rp->keys == NULL || rp->row_partitions == NULL) {
+            free_rows(rp);
+            return false;
+        }
+        rp->rows_capacity = count;
+    }
+    // key only partitioning does not pay for the values
+    return !with_values || reserve_values(rp, count);
+}
+
+/*
+ * public functions
+ */
+
+struct oha_rp * oha_rp_create(const struct oha_rp_config * config)
+{
+    if (config == NULL || config->radix_bits > MAX_RADIX_BITS) {
+        return NULL;
+    }
+    if (oha_lpht_calculate_size(&config->table) == 0) {
+        return NULL;
+    }
+    uint32_t radix_bits = config->radix_bits == 0 ? select_radix_bits(&config->table) : config->radix_bits;
+    if (config->table.max_elems < ((oha_capacity_t)1 << radix_bits)) {
+        return NULL;
+    }
+
+    struct oha_rp * rp = oha_calloc(&config->table.memory, sizeof(struct oha_rp));
+    if (rp == NULL) {
+        return NULL;
+    }
+    rp->memory = config->table.memory;
+#ifdef OHA_FIX_KEY_SIZE_IN_BYTES
+    rp->key_size = OHA_FIX_KEY_SIZE_IN_BYTES;
+#else
+    rp->key_size = config->table.key_size;
+#endif
+    rp->value_size = config->table.value_size;
+    rp->radix_bits = radix_bits;
+    rp->num_partitions = (uint32_t)1 << radix_bits;
+    if (!create_tables(rp, &config->table) || !create_buffers(rp)) {
+        oha_rp_destroy(rp);
+        return NULL;
+    }
+    return rp;
+}
+
+void oha_rp_destroy(struct oha_rp * rp)
+{
+    if (rp == NULL) {
+        return;
+    }
+    free_rows(rp);
+    oha_free(&rp->memory, rp->tables_memory);
+    oha_free(&rp->memory, rp->tables);
+    oha_free(&rp->memory, rp->buffers_memory);
+    oha_free(&rp->memory, rp->buffer_fill);
+    oha_free(&rp->memory, rp->offsets);
+    struct oha_memory_fp memory = rp->memory;
+    oha_free(&memory, rp);
+}
+
+uint32_t oha_rp_get_num_partitions(struct oha_rp * rp)
+{
+    return rp == NULL ? 0 : rp->num_partitions;
+}
+
+bool oha_rp_partition(struct oha_rp * rp, const void * keys, const void * values, size_t count)
+{
+    if (rp == NULL || (keys == NULL && count > 0) || !reserve_rows(rp, count, values != NULL)) {
+        return false;
+    }
+    const size_t key_size = rp->key_size;
+    const size_t value_size = rp->value_size;
+    const uint8_t * input_keys = keys;
+    const uint8_t * input_values = values;
+    rp->has_values = values != NULL;
+
+    // 1. histogram, the partition is the radix of the upper hash bits
+    size_t * offsets = rp->offsets;
+    memset(offsets, 0, sizeof(size_t) * (rp->num_partitions + 1));
+    for (size_t i = 0; i < count; i++) {
+        uint32_t partition = oha_lpht_get_partition(rp->tables[0], input_keys + i * key_size, rp->num_partitions);
+        rp->row_partitions[i] = partition;
+        offsets[partition + 1]++;
+    }
+    for (uint32_t i = 0; i < rp->num_partitions; i++) {
+        offsets[i + 1] += offsets[i];
+    }
+
+    // 2. scatter through the write combining buffers, offsets[i] is the write position of partition i meanwhile
+    const size_t key_buffer_size = align_cache_line(rp->buffer_rows * key_size);
+    const size_t value_buffer_size = align_cache_line(rp->buffer_rows * value_size);
+    memset(rp->buffer_fill, 0, sizeof(size_t) * rp->num_partitions);
+    for (size_t i = 0; i < count; i++) {
+        uint32_t partition = rp->row_partitions[i];
+        size_t fill = rp->buffer_fill[partition];
+        uint8_t * key_buffer = rp->key_buffers + partition * key_buffer_size;
+        uint8_t * value_buffer = rp->value_buffers + partition * value_buffer_size;
+        memcpy(key_buffer + fill * key_size, input_keys + i * key_size, key_size);
+        if (rp->has_values) {
+            memcpy(value_buffer + fill * value_size, input_values + i * value_size, value_size);
+        }
+        fill++;
+        if (fill == rp->buffer_rows) {
+            size_t position = offsets[partition];
+            memcpy(rp->keys + position * key_size, key_buffer, fill * key_size);
+            if (rp->has_values) {
+                memcpy(rp->values + position * value_size, value_buffer, fill * value_size);
+            }
+            offsets[partition] += fill;
+            fill = 0;
+        }
+        rp->buffer_fill[partition] = fill;
+    }
+    for (uint32_t partition = 0; partition < rp->num_partitions; partition++) {
+        size_t fill = rp->buffer_fill[partition];
+        if (fill == 0) {
+            // the rows are not allocated for empty inputs
+            continue;
+        }
+        size_t position = offsets[partition];
+        memcpy(rp->keys + position * key_size, rp->key_buffers + partition * key_buffer_size, fill * key_size);
+        if (rp->has_values) {
+            memcpy(
+                rp->values + position * value_size, rp->value_buffers + partition * value_buffer_size, fill * value_size);
+        }
+        offsets[partition] += fill;
+    }
+
+    // the write positions are the end offsets now, shift them back to the start offsets
+    memmove(&offsets[1], &offsets[0], sizeof(size_t) * rp->num_partitions);
+    offsets[0] = 0;
+    return true;
+}
+
+size_t oha_rp_get_rows(struct oha_rp * rp, uint32_t partition, const void ** keys, const void ** values)
+{
+    if (rp == NULL || partition >= rp->num_partitions || keys == NULL || values == NULL) {
+        return 0;
+    }
+    *keys = rp->keys + rp->offsets[partition] * rp->key_size;
+    *values = rp->has_values ? rp->values + rp->offsets[partition] * rp->value_size : NULL;
+    return rp->offsets[partition + 1] - rp->offsets[partition];
+}
+
+struct oha_lpht * oha_rp_get_table(struct oha_rp * rp, uint32_t partition)
+{
+    if (rp == NULL || partition >= rp->num_partitions) {
+        return NULL;
+    }
+    return rp->tables[partition];
+}
@@ -0,0 +1,93 @@
+#if defined(__linux__)
+#define _GNU_SOURCE
+#elif defined(__unix__) || defined(__APPLE__)
+#define _DEFAULT_SOURCE
+#endif
+
+#include "oha.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define OHA_WITH_FORK
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "utils.h"
+
+// the mapping size is stored in front of the table, the table itself starts cache line aligned
+#define MAPPING_HEADER_SIZE 64
+
+void * oha_cow_alloc(size_t size, void * context)
+{
+    (void)context;
+    size_t mapping_size;
+    if (size == 0 || !oha_add_size(size, MAPPING_HEADER_SIZE, &mapping_size)) {
+        return NULL;
+    }
+#ifdef OHA_WITH_FORK
+    uint8_t * mapping = mmap(NULL, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) {
+        return NULL;
+    }
+#ifdef MADV_NOHUGEPAGE
+    // a write after the fork copies only one small page instead of a whole huge page
+    (void)madvise(mapping, mapping_size, MADV_NOHUGEPAGE);
+#endif
+#else
+    uint8_t * mapping = malloc(mapping_size);
+    if (mapping == NULL) {
+        return NULL;
+    }
+#endif
+    memcpy(mapping, &mapping_size, sizeof(mapping_size));
+    return mapping + MAPPING_HEADER_SIZE;
+}
+
+void oha_cow_free(void * ptr, void * context)
+{
+    (void)context;
+    if (ptr == NULL) {
+        return;
+    }
+    uint8_t * mapping = (uint8_t *)ptr - MAPPING_HEADER_SIZE;
+#ifdef OHA_WITH_FORK
+    size_t mapping_size;
+    memcpy(&mapping_size, mapping, sizeof(mapping_size));
+    munmap(mapping, mapping_size);
+#else
+    free(mapping);
+#endif
+}
+
+struct oha_memory_fp oha_cow_get_memory_fp(void)
+{
+    struct oha_memory_fp memory = {
+        .alloc = oha_cow_alloc,
+        .free = oha_cow_free,
+        .context = NULL,
+    };
+    return memory;
+}
+
+int oha_lpht_fork_snapshot(struct oha_lpht * table,
+                           int (*export_fn)(struct oha_lpht * table, void * context),
+                           void * context)
+{
+    if (table == NULL || export_fn == NULL) {
+        return -1;
+    }
+#ifdef OHA_WITH_FORK
+    pid_t pid = fork();
+    if (pid == 0) {
+        // the child sees the table of the fork time, writes of the parent copy the touched pages
+        _exit(export_fn(table, context));
+    }
+    return pid;
+#else
+    (void)context;
+    return -1;
+#endif
+}
@@ -1,8 +1,13 @@
 #ifndef OHA_UTILS_H_
 #define OHA_UTILS_H_
 
+#include <math.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include "oha.h"
 
 #if SIZE_MAX == (18446744073709551615UL)
 #define SIZE_T_WIDTH 8
@@ -12,12 +17,28 @@
 #error "unsupported plattform"
 #endif
 
+#define OHA_FORCE_INLINE static inline __attribute__((always_inline))
+
+#define CACHE_LINE_SIZE 64
+
 #define MAX(x, y) (((x) > (y)) ? (x) : (y))
 #define MIN(x, y) (((x) < (y)) ? (x) : (y))
 
+// rounds up to a multiple of the size_t width, so arrays of the padded structs stay aligned
 static inline size_t add_alignment(size_t unaligned_size)
 {
-    return unaligned_size + (unaligned_size % SIZE_T_WIDTH);
+    return (unaligned_size + SIZE_T_WIDTH - 1) & ~(size_t)(SIZE_T_WIDTH - 1);
+}
+
+// overflow checked size calculations, return false if the result does not fit into size_t
+static inline bool oha_add_size(uint64_t a, uint64_t b, size_t * result)
+{
+    return !__builtin_add_overflow(a, b, result);
+}
+
+static inline bool oha_mul_size(uint64_t a, uint64_t b, size_t * result)
+{
+    return !__builtin_mul_overflow(a, b, result);
 }
 
 static inline void * move_ptr_num_bytes(void * ptr, size_t num_bytes)
@@ -25,4 +46,58 @@ static inline void * move_ptr_num_bytes(void * ptr, size_t num_bytes)
     return (((uint8_t *)ptr) + num_bytes);
 }
 
+static inline size_t align_cache_line(size_t size)
+{
+    return (size + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1);
+}
+
+static inline void * align_ptr_cache_line(void * ptr)
+{
+    return (void *)align_cache_line((uintptr_t)ptr);
+}
+
+// capacity of one of num_partitions tables, which are filled by the upper bits of a hash
+static inline oha_capacity_t get_partition_max_elems(oha_capacity_t max_elems, uint32_t num_partitions)
+{
+    if (num_partitions == 1) {
+        return max_elems;
+    }
+    oha_capacity_t max_elems_per_partition = max_elems / num_partitions + (max_elems % num_partitions != 0);
+    // the hash distributes the keys binomial, add some standard deviations
+    double slack = 4 * sqrt((double)max_elems_per_partition) + 16;
+    return max_elems_per_partition + (oha_capacity_t)slack;
+}
+
+// allocates zeroed memory with the configured allocator or calloc as fallback
+static inline void * oha_calloc(const struct oha_memory_fp * memory, size_t size)
+{
+    if (memory == NULL || memory->alloc == NULL) {
+        return calloc(1, size);
+    }
+    void * ptr = memory->alloc(size, memory->context);
+    if (ptr != NULL) {
+        memset(ptr, 0, size);
+    }
+    return ptr;
+}
+
+static inline void oha_free(const struct oha_memory_fp * memory, void * ptr)
+{
+    if (memory == NULL || memory->alloc == NULL) {
+        free(ptr);
+        return;
+    }
+    if (memory->free != NULL) {
+        memory->free(ptr, memory->context);
+    }
+}
+
+// options of the lpht config, which the other tables sharing the config do not implement
+static inline bool has_lpht_only_options(const struct oha_lpht_config * config)
+{
+    return config->key_from_value || config->filter_bits_per_elem != 0 || config->cache_hashes ||
+           config->shrink_threshold != 0.0 || config->seed != 0 || config->reseed_probe_length != 0 ||
+           config->max_probe != 0;
+}
+
 #endif
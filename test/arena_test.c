@@ -0,0 +1,113 @@
+#include <stdlib.h>
+#include <unity.h>
+
+#include "oha.h"
+
+/* Is run before every test, put unit init calls here. */
+void setUp(void)
+{
+}
+/* Is run after every test, put unit clean-up calls here. */
+void tearDown(void)
+{
+}
+
+void test_create_destroy()
+{
+    struct oha_arena * arena = oha_arena_create(0);
+    TEST_ASSERT_NOT_NULL(arena);
+    oha_arena_destroy(arena);
+}
+
+void test_alloc_reuse()
+{
+    struct oha_arena * arena = oha_arena_create(4096);
+    TEST_ASSERT_NOT_NULL(arena);
+
+    uint8_t * a = oha_arena_alloc(100, arena);
+    uint8_t * b = oha_arena_alloc(100, arena);
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_TRUE(a + 100 <= b || b + 100 <= a);
+    TEST_ASSERT_EQUAL_UINT64(0, (uintptr_t)a % 16);
+
+    // same size class is reused
+    oha_arena_free(a, arena);
+    TEST_ASSERT_EQUAL_PTR(a, oha_arena_alloc(120, arena));
+
+    // bigger than one block
+    uint8_t * big = oha_arena_alloc(3 * 4096, arena);
+    TEST_ASSERT_NOT_NULL(big);
+    big[3 * 4096 - 1] = 1;
+
+    oha_arena_reset(arena);
+    TEST_ASSERT_NOT_NULL(oha_arena_alloc(100, arena));
+
+    oha_arena_destroy(arena);
+}
+
+void test_host_many_tables()
+{
+    struct oha_arena * arena = oha_arena_create(0);
+    TEST_ASSERT_NOT_NULL(arena);
+
+    const struct oha_lpht_config config = {
+        .load_factor = 0.8,
+        .key_size = sizeof(uint64_t),
+        .value_size = sizeof(uint64_t),
+        .max_elems = 16,
+        .memory = oha_arena_get_memory_fp(arena),
+    };
+    const struct oha_bh_config heap_config = {
+        .value_size = sizeof(uint64_t),
+        .max_elems = 16,
+        .memory = oha_arena_get_memory_fp(arena),
+    };
+
+    for (int round = 0; round < 3; round++) {
+        struct oha_lpht * tables[64];
+        struct oha_bh * heaps[64];
+        for (size_t t = 0; t < 64; t++) {
+            tables[t] = oha_lpht_create(&config);
+            TEST_ASSERT_NOT_NULL(tables[t]);
+            heaps[t] = oha_bh_create(&heap_config);
+            TEST_ASSERT_NOT_NULL(heaps[t]);
+            for (uint64_t i = 0; i < config.max_elems; i++) {
+                uint64_t key = i + t;
+                uint64_t * value = oha_lpht_insert(tables[t], &key);
+                TEST_ASSERT_NOT_NULL(value);
+                *value = key;
+                TEST_ASSERT_NOT_NULL(oha_bh_insert(heaps[t], key));
+            }
+        }
+        for (size_t t = 0; t < 64; t++) {
+            for (uint64_t i = 0; i < config.max_elems; i++) {
+                uint64_t key = i + t;
+                uint64_t * value = oha_lpht_look_up(tables[t], &key);
+                TEST_ASSERT_NOT_NULL(value);
+                TEST_ASSERT_EQUAL_UINT64(key, *value);
+                TEST_ASSERT_EQUAL_INT64(t + i, oha_bh_find_min(heaps[t]));
+                oha_bh_delete_min(heaps[t]);
+            }
+            // destroy half of them, the rest is released by the reset
+            if (t % 2 == 0) {
+                oha_lpht_destroy(tables[t]);
+                oha_bh_destroy(heaps[t]);
+            }
+        }
+        oha_arena_reset(arena);
+    }
+
+    oha_arena_destroy(arena);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_create_destroy);
+    RUN_TEST(test_alloc_reuse);
+    RUN_TEST(test_host_many_tables);
+
+    return UNITY_END();
+}
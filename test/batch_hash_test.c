@@ -0,0 +1,97 @@
+#include <stdlib.h>
+#include <unity.h>
+
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
+#include "batch_hash.h"
+
+#define NUM_KEYS 1003 // not a multiple of the vector width, the tails are hashed scalar
+#define SEED 0xc800c831bc63dff8
+
+/* Is run before every test, put unit init calls here. */
+void setUp(void)
+{
+}
+/* Is run after every test, put unit clean-up calls here. */
+void tearDown(void)
+{
+}
+
+typedef void (*hash_batch_fn)(const void * keys, size_t key_size, size_t count, uint64_t seed, uint64_t * hashes);
+
+static void check_kernel(hash_batch_fn kernel)
+{
+    uint64_t keys[NUM_KEYS];
+    uint64_t hashes[NUM_KEYS];
+    uint64_t state = 42;
+    for (size_t i = 0; i < NUM_KEYS; i++) {
+        // xorshift, keys with all bits in use
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        keys[i] = state;
+    }
+    keys[0] = 0;
+    keys[1] = UINT64_MAX;
+
+    for (size_t key_size = 4; key_size <= 8; key_size += 4) {
+        for (uint64_t seed = 0; seed < 2; seed++) {
+            kernel(keys, key_size, NUM_KEYS, seed * SEED, hashes);
+            for (size_t i = 0; i < NUM_KEYS; i++) {
+                TEST_ASSERT_EQUAL_HEX64(XXH64((uint8_t *)keys + i * key_size, key_size, seed * SEED), hashes[i]);
+            }
+        }
+        // unaligned keys
+        kernel((uint8_t *)keys + 1, key_size, NUM_KEYS - 1, SEED, hashes);
+        for (size_t i = 0; i < NUM_KEYS - 1; i++) {
+            TEST_ASSERT_EQUAL_HEX64(XXH64((uint8_t *)keys + 1 + i * key_size, key_size, SEED), hashes[i]);
+        }
+    }
+}
+
+void test_scalar()
+{
+    check_kernel(oha_xxh64_batch_scalar);
+}
+
+void test_dispatch()
+{
+    check_kernel(oha_xxh64_batch);
+}
+
+void test_avx2()
+{
+#ifdef OHA_WITH_BATCH_HASH
+    if (!__builtin_cpu_supports("avx2")) {
+        TEST_IGNORE_MESSAGE("no AVX2 support");
+    }
+    check_kernel(oha_xxh64_batch_avx2);
+#else
+    TEST_IGNORE_MESSAGE("no x86-64 vector kernels");
+#endif
+}
+
+void test_avx512()
+{
+#ifdef OHA_WITH_BATCH_HASH
+    if (!__builtin_cpu_supports("avx512f") || !__builtin_cpu_supports("avx512dq")) {
+        TEST_IGNORE_MESSAGE("no AVX-512 support");
+    }
+    check_kernel(oha_xxh64_batch_avx512);
+#else
+    TEST_IGNORE_MESSAGE("no x86-64 vector kernels");
+#endif
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_scalar);
+    RUN_TEST(test_dispatch);
+    RUN_TEST(test_avx2);
+    RUN_TEST(test_avx512);
+
+    return UNITY_END();
+}
@@ -1,8 +1,10 @@
 #include <assert.h>
+#include <chrono>
 #include <iostream>
 #include <stdint.h>
 #include <oha.h>
 #include <unordered_map>
+#include <vector>
 
 using namespace std;
 
@@ -40,6 +42,19 @@ struct value {
     uint64_t array[1];
 };
 
+struct operation {
+    enum command cmd;
+    uint64_t key;
+};
+
+static void print_memory(const char * name, size_t size_in_bytes)
+{
+    printf("memory:\n -%s:\t%zu bytes\n -per entry:\t%.2f bytes\n",
+           name,
+           size_in_bytes,
+           (double)size_in_bytes / MAX_ELEMENTS);
+}
+
 int main(int argc, char * argv[])
 {
     if (argc != 3) {
@@ -48,11 +63,15 @@ int main(int argc, char * argv[])
                 " mode:\n"
                 "   1: using lpth\n"
                 "   2: using c++ std::unordered_map<>\n"
+                "   3: using ccht (bucketized cuckoo hash table)\n"
+                "   4: using hsht (hopscotch hash table)\n"
                 " example: ./benchmark ../../test/benchmark.txt 1\n");
         return 1;
     }
     unordered_map<uint64_t, struct value> * umap = NULL;
     struct oha_lpht * table = NULL;
+    struct oha_ccht * ccht = NULL;
+    struct oha_hsht * hsht = NULL;
     char * line_buf = NULL;
     size_t line_buf_size = 0;
     int line_count = 0;
@@ -72,88 +91,161 @@ int main(int argc, char * argv[])
         .value_size = sizeof(struct value),
         .max_elems = MAX_ELEMENTS,
     };
+    // the cuckoo table runs with high occupancy at the same capacity
+    struct oha_lpht_config ccht_config = config;
+    ccht_config.load_factor = 0.95;
+    struct oha_lpht_config hsht_config = config;
+    hsht_config.load_factor = 0.8;
 
     switch (mode) {
         case 1:
             printf("create linear polling hash table\n");
             table = oha_lpht_create(&config);
+            print_memory("lpht", oha_lpht_calculate_size(&config));
             break;
         case 2:
             printf("create std::unordered_map\n");
             umap = new unordered_map<uint64_t, struct value>(MAX_ELEMENTS);
             break;
+        case 3:
+            printf("create bucketized cuckoo hash table\n");
+            ccht = oha_ccht_create(&ccht_config);
+            print_memory("ccht", oha_ccht_calculate_size(&ccht_config));
+            break;
+        case 4:
+            printf("create hopscotch hash table\n");
+            hsht = oha_hsht_create(&hsht_config);
+            print_memory("hsht", oha_hsht_calculate_size(&hsht_config));
+            break;
         default:
             fprintf(stderr, "unsupported mode %s\n", argv[2]);
             exit(1);
     }
 
-    /* Get initial line */
+    // parse the whole file first, to measure only the table operations
+    vector<struct operation> operations;
     line_size = getline(&line_buf, &line_buf_size, fp);
-
-    uint64_t key;
-    struct value * value;
-    uint64_t inserts = 0;
-    uint64_t lookups = 0;
-    uint64_t removes = 0;
     while (line_size >= 0) {
         line_count++;
+        struct operation op;
+        op.cmd = get_cmd(line_buf, line_size, op.key);
+        if (op.cmd == INVALID) {
+            fprintf(stderr, "invalid command in line %d \n", line_count);
+            retval = 3;
+            goto EXIT;
+        }
+        operations.push_back(op);
+        line_size = getline(&line_buf, &line_buf_size, fp);
+    }
 
-        enum command cmd = get_cmd(line_buf, line_size, key);
-        switch (cmd) {
-            case INVALID:
-                fprintf(stderr, "invalid command in line %d \n", line_count);
-                retval = 3;
-                goto EXIT;
-                break;
-            case INSERT:
-                // printf("insert: %lu\n", key);
-                struct value tmp;
-                tmp.array[0] = key;
-                switch (mode) {
-                    case 1:
-                        value = (struct value *)oha_lpht_insert(table, &key);
-                        // crash if insert failed because of memory
-                        *value = tmp;
-                        break;
-                    case 2:
-                        pair<uint64_t, struct value> tmp_pair(key, tmp);
-                        umap->insert(tmp_pair);
-                        break;
-                }
-                inserts++;
-                break;
-            case LOOKUP:
-                // printf("lookup: %lu\n", key);
-                switch (mode) {
-                    case 1:
-                        value = (struct value *)oha_lpht_look_up(table, &key);
-                        break;
-                    case 2:
-                        unordered_map<uint64_t, struct value>::const_iterator got = umap->find(key);
+    {
+        struct value * value;
+        uint64_t inserts = 0;
+        uint64_t lookups = 0;
+        uint64_t removes = 0;
+        uint64_t found = 0;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (const struct operation & op : operations) {
+            switch (op.cmd) {
+                case INVALID:
+                    break;
+                case INSERT: {
+                    struct value tmp;
+                    tmp.array[0] = op.key;
+                    switch (mode) {
+                        case 1:
+                            value = (struct value *)oha_lpht_insert(table, &op.key);
+                            // crash if insert failed because of memory
+                            *value = tmp;
+                            break;
+                        case 2: {
+                            pair<uint64_t, struct value> tmp_pair(op.key, tmp);
+                            umap->insert(tmp_pair);
+                            break;
+                        }
+                        case 3:
+                            value = (struct value *)oha_ccht_insert(ccht, &op.key);
+                            *value = tmp;
+                            break;
+                        case 4:
+                            value = (struct value *)oha_hsht_insert(hsht, &op.key);
+                            *value = tmp;
+                            break;
+                    }
+                    inserts++;
+                    break;
                 }
-                lookups++;
-                break;
-            case REMOVE:
-                // printf("remove: %lu\n", key);
-                switch (mode) {
-                    case 1:
-                        value = (struct value *)oha_lpht_remove(table, &key);
-                        break;
-                    case 2:
-                        umap->erase(key);
-                        break;
-                }
-                removes++;
-                break;
+                case LOOKUP:
+                    switch (mode) {
+                        case 1:
+                            value = (struct value *)oha_lpht_look_up(table, &op.key);
+                            found += value != NULL;
+                            break;
+                        case 2:
+                            found += umap->find(op.key) != umap->end();
+                            break;
+                        case 3:
+                            value = (struct value *)oha_ccht_look_up(ccht, &op.key);
+                            found += value != NULL;
+                            break;
+                        case 4:
+                            value = (struct value *)oha_hsht_look_up(hsht, &op.key);
+                            found += value != NULL;
+                            break;
+                    }
+                    lookups++;
+                    break;
+                case REMOVE:
+                    switch (mode) {
+                        case 1:
+                            value = (struct value *)oha_lpht_remove(table, &op.key);
+                            break;
+                        case 2:
+                            umap->erase(op.key);
+                            break;
+                        case 3:
+                            value = (struct value *)oha_ccht_remove(ccht, &op.key);
+                            break;
+                        case 4:
+                            value = (struct value *)oha_hsht_remove(hsht, &op.key);
+                            break;
+                    }
+                    removes++;
+                    break;
+            }
         }
-        /* Get the next line */
-        line_size = getline(&line_buf, &line_buf_size, fp);
+        chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+
+        printf("test:\n -inserts:\t%lu\n -look ups:\t%lu\n -removes:\t%lu\n", inserts, lookups, removes);
+        printf("time:\n -total:\t%.3f ms\n -per operation:\t%.2f ns\n -found:\t%lu\n",
+               elapsed.count() / 1e6,
+               operations.empty() ? 0.0 : elapsed.count() / operations.size(),
+               found);
     }
 
-    printf("test:\n -inserts:\t%lu\n -look ups:\t%lu\n -removes:\t%lu\n", inserts, lookups, removes);
+    struct oha_lpht_statistics stats;
+    if (mode == 1 && oha_lpht_get_statistics(table, &stats)) {
+        printf("statistics:\n"
+               " -look ups:\t\t%lu\n"
+               " -hits:\t\t\t%lu\n"
+               " -misses:\t\t%lu\n"
+               " -probe steps:\t\t%lu\n"
+               " -key compares:\t\t%lu\n"
+               " -probify moves:\t%lu\n"
+               " -full inserts:\t\t%lu\n",
+               stats.look_ups,
+               stats.hits,
+               stats.misses,
+               stats.probe_steps,
+               stats.key_compares,
+               stats.probify_moves,
+               stats.insert_failures_full);
+    }
 EXIT:
     delete umap;
     oha_lpht_destroy(table);
+    oha_ccht_destroy(ccht);
+    oha_hsht_destroy(hsht);
     /* Free the allocated line buffer */
     free(line_buf);
     line_buf = NULL;
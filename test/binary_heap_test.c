@@ -50,6 +50,34 @@ void test_create_destroy()
     oha_bh_destroy(heap);
 }
 
+void test_initialize_destroy()
+{
+    const struct oha_bh_config config = {
+        .value_size = sizeof(int64_t),
+        .max_elems = 100,
+    };
+
+    size_t heap_memory_size = oha_bh_calculate_size(&config);
+    TEST_ASSERT_TRUE(heap_memory_size > 0);
+    void * memory = calloc(1, heap_memory_size);
+    struct oha_bh * heap = oha_bh_initialize(&config, memory);
+    TEST_ASSERT_NOT_NULL(heap);
+
+    for (int64_t i = config.max_elems; i > 0; i--) {
+        int64_t * value = oha_bh_insert(heap, i);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = i;
+    }
+    TEST_ASSERT_NULL(oha_bh_insert(heap, 0));
+    for (int64_t i = 1; i <= (int64_t)config.max_elems; i++) {
+        TEST_ASSERT_EQUAL_INT64(i, oha_bh_find_min(heap));
+        int64_t * value = oha_bh_delete_min(heap);
+        TEST_ASSERT_EQUAL_INT64(i, *value);
+    }
+
+    oha_bh_destroy(heap);
+}
+
 void test_insert_delete_min()
 {
     const size_t array_size = 100 * 1000;
@@ -226,6 +254,7 @@ int main(void)
     UNITY_BEGIN();
 
     RUN_TEST(test_create_destroy);
+    RUN_TEST(test_initialize_destroy);
     RUN_TEST(test_insert_delete_min);
     RUN_TEST(test_insert_delete_min_check_value_ptr);
     RUN_TEST(test_decrease_key);
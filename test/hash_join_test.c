@@ -0,0 +1,143 @@
+#include <stdlib.h>
+#include <unity.h>
+
+#include "oha.h"
+
+#define LOAF_FACTOR 0.7
+#define BUILD_COUNT 200
+#define PROBE_COUNT 300
+
+/* Is run before every test, put unit init calls here. */
+void setUp(void)
+{
+}
+/* Is run after every test, put unit clean-up calls here. */
+void tearDown(void)
+{
+}
+
+static const struct oha_hj_config config = {
+    .load_factor = LOAF_FACTOR,
+    .key_size = sizeof(uint64_t),
+};
+
+void test_create_destroy()
+{
+    uint64_t key = 1;
+    struct oha_hj * join = oha_hj_create(&config, &key, 1);
+    TEST_ASSERT_NOT_NULL(join);
+    oha_hj_destroy(join);
+
+    // empty build side
+    join = oha_hj_create(&config, NULL, 0);
+    TEST_ASSERT_NOT_NULL(join);
+    TEST_ASSERT_EQUAL(OHA_HJ_END, oha_hj_find(join, &key));
+    oha_hj_destroy(join);
+
+    TEST_ASSERT_NULL(oha_hj_create(NULL, &key, 1));
+    TEST_ASSERT_NULL(oha_hj_create(&config, NULL, 1));
+    oha_hj_destroy(NULL);
+}
+
+void test_find_next()
+{
+    // every key 4 times
+    uint64_t build_keys[BUILD_COUNT];
+    for (size_t i = 0; i < BUILD_COUNT; i++) {
+        build_keys[i] = i % 50;
+    }
+    struct oha_hj * join = oha_hj_create(&config, build_keys, BUILD_COUNT);
+    TEST_ASSERT_NOT_NULL(join);
+
+    for (uint64_t key = 0; key < 100; key++) {
+        size_t build_idx = oha_hj_find(join, &key);
+        if (key >= 50) {
+            TEST_ASSERT_EQUAL(OHA_HJ_END, build_idx);
+            continue;
+        }
+        for (size_t i = 0; i < 4; i++) {
+            TEST_ASSERT_EQUAL(key + i * 50, build_idx);
+            build_idx = oha_hj_next(join, build_idx);
+        }
+        TEST_ASSERT_EQUAL(OHA_HJ_END, build_idx);
+    }
+    TEST_ASSERT_EQUAL(OHA_HJ_END, oha_hj_next(join, BUILD_COUNT));
+    oha_hj_destroy(join);
+}
+
+// joins with an output buffer of max_matches and compares the result with a nested loop join
+static void check_probe(size_t max_matches)
+{
+    uint64_t build_keys[BUILD_COUNT];
+    for (size_t i = 0; i < BUILD_COUNT; i++) {
+        // keys 0..49 have 1 to 7 duplicates, other keys are unique
+        build_keys[i] = i < 150 ? (i * 7) % 50 : i;
+    }
+    uint64_t probe_keys[PROBE_COUNT];
+    for (size_t i = 0; i < PROBE_COUNT; i++) {
+        probe_keys[i] = (i * 13) % 250;
+    }
+    struct oha_hj * join = oha_hj_create(&config, build_keys, BUILD_COUNT);
+    TEST_ASSERT_NOT_NULL(join);
+
+    struct oha_hj_match * matches = malloc(sizeof(struct oha_hj_match) * max_matches);
+    struct oha_hj_cursor cursor = {0};
+    size_t probe_idx = 0;
+    size_t build_idx = 0;
+    size_t calls = 0;
+    while (cursor.probe_idx < PROBE_COUNT) {
+        size_t n = oha_hj_probe(join, probe_keys, PROBE_COUNT, &cursor, matches, max_matches);
+        TEST_ASSERT_TRUE(n <= max_matches);
+        calls++;
+        TEST_ASSERT_TRUE(calls < BUILD_COUNT * PROBE_COUNT);
+        for (size_t i = 0; i < n; i++) {
+            // the next match of the nested loop join
+            while (build_keys[build_idx] != probe_keys[probe_idx]) {
+                build_idx++;
+                if (build_idx == BUILD_COUNT) {
+                    build_idx = 0;
+                    probe_idx++;
+                    TEST_ASSERT_TRUE(probe_idx < PROBE_COUNT);
+                }
+            }
+            TEST_ASSERT_EQUAL(probe_idx, matches[i].probe_idx);
+            TEST_ASSERT_EQUAL(build_idx, matches[i].build_idx);
+            build_idx++;
+            if (build_idx == BUILD_COUNT) {
+                build_idx = 0;
+                probe_idx++;
+            }
+        }
+    }
+    // no match is missing at the end
+    for (; probe_idx < PROBE_COUNT; probe_idx++) {
+        for (; build_idx < BUILD_COUNT; build_idx++) {
+            TEST_ASSERT_TRUE(build_keys[build_idx] != probe_keys[probe_idx]);
+        }
+        build_idx = 0;
+    }
+    TEST_ASSERT_EQUAL(0, oha_hj_probe(join, probe_keys, PROBE_COUNT, &cursor, matches, max_matches));
+
+    free(matches);
+    oha_hj_destroy(join);
+}
+
+void test_probe()
+{
+    check_probe(1);
+    check_probe(3);
+    check_probe(7);
+    check_probe(64);
+    check_probe(BUILD_COUNT * PROBE_COUNT);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_create_destroy);
+    RUN_TEST(test_find_next);
+    RUN_TEST(test_probe);
+
+    return UNITY_END();
+}
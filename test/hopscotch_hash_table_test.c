@@ -0,0 +1,150 @@
+#include <stdlib.h>
+#include <unity.h>
+
+#include "oha.h"
+
+#define LOAF_FACTOR 0.9
+
+/* Is run before every test, put unit init calls here. */
+void setUp(void)
+{
+}
+/* Is run after every test, put unit clean-up calls here. */
+void tearDown(void)
+{
+}
+
+void test_create_destroy()
+{
+    const struct oha_lpht_config config = {
+        .load_factor = LOAF_FACTOR,
+        .key_size = sizeof(uint64_t),
+        .value_size = sizeof(uint64_t),
+        .max_elems = 100,
+    };
+
+    struct oha_hsht * table = oha_hsht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+    oha_hsht_destroy(table);
+
+    void * memory = calloc(1, oha_hsht_calculate_size(&config));
+    table = oha_hsht_initialize(&config, memory);
+    TEST_ASSERT_NOT_NULL(table);
+    oha_hsht_destroy(table);
+
+    // options of the lpht only are rejected
+    struct oha_lpht_config lpht_config = config;
+    lpht_config.key_from_value = true;
+    TEST_ASSERT_NULL(oha_hsht_create(&lpht_config));
+    TEST_ASSERT_EQUAL(0, oha_hsht_calculate_size(&lpht_config));
+    lpht_config = config;
+    lpht_config.seed = 42;
+    TEST_ASSERT_NULL(oha_hsht_create(&lpht_config));
+    lpht_config = config;
+    lpht_config.cache_hashes = true;
+    TEST_ASSERT_NULL(oha_hsht_create(&lpht_config));
+}
+
+void test_insert_look_up_remove()
+{
+    for (uint32_t elems = 1; elems <= 4096; elems *= 2) {
+        const struct oha_lpht_config config = {
+            .load_factor = LOAF_FACTOR,
+            .key_size = sizeof(uint64_t),
+            .value_size = sizeof(uint64_t),
+            .max_elems = elems,
+        };
+        struct oha_hsht * table = oha_hsht_create(&config);
+        TEST_ASSERT_NOT_NULL(table);
+
+        uint64_t ** values = calloc(config.max_elems, sizeof(uint64_t *));
+        for (uint64_t i = 0; i < config.max_elems; i++) {
+            bool inserted;
+            values[i] = oha_hsht_insert_ex(table, &i, &inserted);
+            TEST_ASSERT_NOT_NULL(values[i]);
+            TEST_ASSERT_TRUE(inserted);
+            *values[i] = i;
+        }
+        uint64_t full = config.max_elems;
+        TEST_ASSERT_NULL(oha_hsht_insert(table, &full));
+
+        struct oha_lpht_status status;
+        TEST_ASSERT_TRUE(oha_hsht_get_status(table, &status));
+        TEST_ASSERT_EQUAL_UINT32(config.max_elems, status.elems_in_use);
+
+        // displacements keep the value pointers stable
+        for (uint64_t i = 0; i < config.max_elems; i++) {
+            uint64_t * value = oha_hsht_look_up(table, &i);
+            TEST_ASSERT_EQUAL_PTR(values[i], value);
+            TEST_ASSERT_EQUAL_UINT64(i, *value);
+            bool inserted;
+            TEST_ASSERT_EQUAL_PTR(values[i], oha_hsht_insert_ex(table, &i, &inserted));
+            TEST_ASSERT_FALSE(inserted);
+        }
+
+        size_t position = 0;
+        uint32_t count = 0;
+        for (struct oha_key_value_pair pair = oha_hsht_get_next_element(table, &position); pair.key != NULL;
+             pair = oha_hsht_get_next_element(table, &position)) {
+            TEST_ASSERT_EQUAL_UINT64(*(uint64_t *)pair.key, *(uint64_t *)pair.value);
+            count++;
+        }
+        TEST_ASSERT_EQUAL_UINT32(config.max_elems, count);
+
+        for (uint64_t i = 0; i < config.max_elems; i += 2) {
+            TEST_ASSERT_EQUAL_PTR(values[i], oha_hsht_remove(table, &i));
+            TEST_ASSERT_NULL(oha_hsht_remove(table, &i));
+        }
+        for (uint64_t i = 0; i < config.max_elems; i++) {
+            if (i % 2 == 0) {
+                TEST_ASSERT_NULL(oha_hsht_look_up(table, &i));
+            } else {
+                TEST_ASSERT_EQUAL_PTR(values[i], oha_hsht_look_up(table, &i));
+            }
+        }
+
+        free(values);
+        oha_hsht_destroy(table);
+    }
+}
+
+void test_big_keys()
+{
+    const struct oha_lpht_config config = {
+        .load_factor = 0.9,
+        .key_size = 40,
+        .value_size = sizeof(uint32_t),
+        .max_elems = 1000,
+    };
+    struct oha_hsht * table = oha_hsht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+
+    uint8_t key[40] = {0};
+    for (uint32_t i = 0; i < config.max_elems; i++) {
+        key[0] = i;
+        key[39] = i >> 8;
+        uint32_t * value = oha_hsht_insert(table, key);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = i;
+    }
+    for (uint32_t i = 0; i < config.max_elems; i++) {
+        key[0] = i;
+        key[39] = i >> 8;
+        uint32_t * value = oha_hsht_look_up(table, key);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_EQUAL_UINT32(i, *value);
+    }
+
+    oha_hsht_destroy(table);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_create_destroy);
+    RUN_TEST(test_insert_look_up_remove);
+    RUN_TEST(test_big_keys);
+
+    return UNITY_END();
+}
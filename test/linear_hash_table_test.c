@@ -167,6 +167,1193 @@ void test_clear_remove()
     oha_lpht_destroy(table);
 }
 
+void test_insert_ex()
+{
+    const struct oha_lpht_config config = {
+        .load_factor = LOAF_FACTOR,
+        .key_size = sizeof(uint64_t),
+        .value_size = sizeof(uint64_t),
+        .max_elems = 100,
+    };
+
+    struct oha_lpht * table = oha_lpht_create(&config);
+    bool inserted;
+
+    for (uint64_t i = 0; i < config.max_elems; i++) {
+        uint64_t * value = oha_lpht_insert_ex(table, &i, &inserted);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_TRUE(inserted);
+        *value = i;
+    }
+
+    // already inserted keys are found in a full table
+    for (uint64_t i = 0; i < config.max_elems; i++) {
+        uint64_t * value = oha_lpht_insert_ex(table, &i, &inserted);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_FALSE(inserted);
+        TEST_ASSERT_EQUAL_UINT64(i, *value);
+    }
+
+    uint64_t full = config.max_elems;
+    TEST_ASSERT_NULL(oha_lpht_insert_ex(table, &full, &inserted));
+    TEST_ASSERT_FALSE(inserted);
+    TEST_ASSERT_NULL(oha_lpht_insert_ex(table, &full, NULL));
+
+    uint64_t key = 0;
+    TEST_ASSERT_NOT_NULL(oha_lpht_remove(table, &key));
+    TEST_ASSERT_NOT_NULL(oha_lpht_insert_ex(table, &full, &inserted));
+    TEST_ASSERT_TRUE(inserted);
+
+    oha_lpht_destroy(table);
+}
+
+static bool is_divisible(const void * key, void * value, void * context)
+{
+    uint64_t divisor = *(uint64_t *)context;
+    TEST_ASSERT_EQUAL_UINT64(*(const uint64_t *)key, *(uint64_t *)value);
+    return *(const uint64_t *)key % divisor == 0;
+}
+
+void test_erase_if()
+{
+    for (size_t elems = 1; elems < 300; elems++) {
+        for (uint64_t divisor = 1; divisor < 5; divisor++) {
+            const struct oha_lpht_config config = {
+                .load_factor = LOAF_FACTOR,
+                .key_size = sizeof(uint64_t),
+                .value_size = sizeof(uint64_t),
+                .max_elems = elems,
+            };
+            struct oha_lpht * table = oha_lpht_create(&config);
+
+            uint64_t * values[elems];
+            for (uint64_t i = 0; i < elems; i++) {
+                values[i] = oha_lpht_insert(table, &i);
+                TEST_ASSERT_NOT_NULL(values[i]);
+                *values[i] = i;
+            }
+
+            uint32_t expected = (elems + divisor - 1) / divisor;
+            TEST_ASSERT_EQUAL_UINT32(expected, oha_lpht_erase_if(table, is_divisible, &divisor));
+
+            struct oha_lpht_status status;
+            TEST_ASSERT_TRUE(oha_lpht_get_status(table, &status));
+            TEST_ASSERT_EQUAL_UINT32(elems - expected, status.elems_in_use);
+
+            for (uint64_t i = 0; i < elems; i++) {
+                uint64_t * value = oha_lpht_look_up(table, &i);
+                if (i % divisor == 0) {
+                    TEST_ASSERT_NULL(value);
+                } else {
+                    // values are not moved in memory
+                    TEST_ASSERT_EQUAL_PTR(values[i], value);
+                    TEST_ASSERT_EQUAL_UINT64(i, *value);
+                }
+            }
+
+            // removing after the sweep still works on the compacted clusters
+            for (uint64_t i = 0; i < elems; i++) {
+                if (i % divisor != 0) {
+                    TEST_ASSERT_NOT_NULL(oha_lpht_remove(table, &i));
+                }
+            }
+            TEST_ASSERT_TRUE(oha_lpht_get_status(table, &status));
+            TEST_ASSERT_EQUAL_UINT32(0, status.elems_in_use);
+
+            oha_lpht_destroy(table);
+        }
+    }
+}
+
+void test_key_sizes()
+{
+    // specialized kernels and the generic one
+    const size_t key_sizes[] = {2, 4, 8, 12, 16, 20, 32, 64};
+    for (size_t k = 0; k < sizeof(key_sizes) / sizeof(key_sizes[0]); k++) {
+        const struct oha_lpht_config config = {
+            .load_factor = LOAF_FACTOR,
+            .key_size = key_sizes[k],
+            .value_size = sizeof(uint64_t),
+            .max_elems = 200,
+        };
+        struct oha_lpht * table = oha_lpht_create(&config);
+        TEST_ASSERT_NOT_NULL(table);
+
+        uint8_t key[64] = {0};
+        for (uint64_t i = 0; i < config.max_elems; i++) {
+            // vary the first and the last byte of the key
+            key[0] = i;
+            key[config.key_size - 1] = i / 2;
+            uint64_t * value = oha_lpht_insert(table, key);
+            TEST_ASSERT_NOT_NULL(value);
+            *value = i;
+        }
+        for (uint64_t i = 0; i < config.max_elems; i++) {
+            key[0] = i;
+            key[config.key_size - 1] = i / 2;
+            uint64_t * value = oha_lpht_look_up(table, key);
+            TEST_ASSERT_NOT_NULL(value);
+            TEST_ASSERT_EQUAL_UINT64(i, *value);
+            if (i % 2 == 0) {
+                TEST_ASSERT_EQUAL_PTR(value, oha_lpht_remove(table, key));
+            }
+        }
+        for (uint64_t i = 0; i < config.max_elems; i++) {
+            key[0] = i;
+            key[config.key_size - 1] = i / 2;
+            uint64_t * value = oha_lpht_look_up(table, key);
+            if (i % 2 == 0) {
+                TEST_ASSERT_NULL(value);
+            } else {
+                TEST_ASSERT_NOT_NULL(value);
+                TEST_ASSERT_EQUAL_UINT64(i, *value);
+            }
+        }
+
+        oha_lpht_destroy(table);
+    }
+}
+
+static bool is_odd(const void * key, void * value, void * context)
+{
+    (void)value;
+    (void)context;
+    return *(const uint64_t *)key % 2 == 1;
+}
+
+void test_key_from_value()
+{
+    const struct oha_lpht_config config = {
+        .load_factor = LOAF_FACTOR,
+        .key_size = sizeof(uint64_t),
+        .value_size = sizeof(uint64_t),
+        .max_elems = 200,
+        .key_from_value = true,
+    };
+
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+
+    for (uint64_t i = 0; i < config.max_elems; i++) {
+        uint64_t * value = oha_lpht_insert(table, &i);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = i;
+        TEST_ASSERT_EQUAL_UINT64(i, *(uint64_t *)oha_lpht_get_key_from_value(table, value));
+    }
+
+    // remove and erase move the values between the key buckets
+    for (uint64_t i = 0; i < config.max_elems; i += 4) {
+        TEST_ASSERT_NOT_NULL(oha_lpht_remove(table, &i));
+    }
+    oha_lpht_erase_if(table, is_odd, NULL);
+
+    for (uint64_t i = 0; i < config.max_elems; i++) {
+        uint64_t * value = oha_lpht_look_up(table, &i);
+        if (i % 4 == 0 || i % 2 == 1) {
+            TEST_ASSERT_NULL(value);
+        } else {
+            TEST_ASSERT_NOT_NULL(value);
+            TEST_ASSERT_EQUAL_UINT64(i, *value);
+            TEST_ASSERT_EQUAL_UINT64(i, *(uint64_t *)oha_lpht_get_key_from_value(table, value));
+        }
+    }
+    TEST_ASSERT_NULL(oha_lpht_get_key_from_value(table, NULL));
+    oha_lpht_destroy(table);
+
+    // tables without key_from_value have no key pointer in front of the values
+    struct oha_lpht_config plain_config = config;
+    plain_config.key_from_value = false;
+    table = oha_lpht_create(&plain_config);
+    TEST_ASSERT_NOT_NULL(table);
+    uint64_t key = 1;
+    uint64_t * value = oha_lpht_insert(table, &key);
+    TEST_ASSERT_NOT_NULL(value);
+    TEST_ASSERT_NULL(oha_lpht_get_key_from_value(table, value));
+    oha_lpht_destroy(table);
+}
+
+void test_statistics()
+{
+    const struct oha_lpht_config config = {
+        .load_factor = LOAF_FACTOR,
+        .key_size = sizeof(uint64_t),
+        .value_size = sizeof(uint64_t),
+        .max_elems = 100,
+    };
+
+    struct oha_lpht * table = oha_lpht_create(&config);
+    struct oha_lpht_statistics stats;
+    if (!oha_lpht_get_statistics(table, &stats)) {
+        oha_lpht_destroy(table);
+        TEST_IGNORE_MESSAGE("library build without OHA_WITH_STATS");
+    }
+    TEST_ASSERT_EQUAL_UINT64(0, stats.look_ups);
+
+    for (uint64_t i = 0; i < config.max_elems; i++) {
+        TEST_ASSERT_NOT_NULL(oha_lpht_insert(table, &i));
+    }
+    uint64_t full = config.max_elems;
+    TEST_ASSERT_NULL(oha_lpht_insert(table, &full));
+
+    for (uint64_t i = 0; i < 2 * config.max_elems; i++) {
+        oha_lpht_look_up(table, &i);
+    }
+    for (uint64_t i = 0; i < config.max_elems; i++) {
+        TEST_ASSERT_NOT_NULL(oha_lpht_remove(table, &i));
+    }
+
+    TEST_ASSERT_TRUE(oha_lpht_get_statistics(table, &stats));
+    TEST_ASSERT_EQUAL_UINT64(2 * config.max_elems, stats.look_ups);
+    TEST_ASSERT_EQUAL_UINT64(config.max_elems, stats.hits);
+    TEST_ASSERT_EQUAL_UINT64(config.max_elems, stats.misses);
+    TEST_ASSERT_EQUAL_UINT64(1, stats.insert_failures_full);
+    TEST_ASSERT_TRUE(stats.key_compares >= stats.hits);
+    TEST_ASSERT_TRUE(stats.probe_steps >= stats.key_compares);
+
+    oha_lpht_reset_statistics(table);
+    TEST_ASSERT_TRUE(oha_lpht_get_statistics(table, &stats));
+    TEST_ASSERT_EQUAL_UINT64(0, stats.look_ups);
+    TEST_ASSERT_EQUAL_UINT64(0, stats.probe_steps);
+
+    oha_lpht_destroy(table);
+}
+
+static bool is_even(const void * key, void * value, void * context)
+{
+    (void)value;
+    (void)context;
+    return *(const uint64_t *)key % 2 == 0;
+}
+
+void test_filter()
+{
+    struct oha_lpht_config config = {
+        .load_factor = LOAF_FACTOR,
+        .key_size = sizeof(uint64_t),
+        .value_size = sizeof(uint64_t),
+        .max_elems = 1000,
+    };
+    const size_t size_without_filter = oha_lpht_calculate_size(&config);
+    config.filter_bits_per_elem = 65;
+    TEST_ASSERT_NULL(oha_lpht_create(&config));
+    config.filter_bits_per_elem = 10;
+    TEST_ASSERT_GREATER_THAN(size_without_filter, oha_lpht_calculate_size(&config));
+
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+    for (uint64_t i = 0; i < config.max_elems; i++) {
+        uint64_t * value = oha_lpht_insert(table, &i);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = i;
+    }
+    for (uint64_t i = 0; i < config.max_elems; i++) {
+        uint64_t * value = oha_lpht_look_up(table, &i);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_EQUAL_UINT64(i, *value);
+    }
+    for (uint64_t i = config.max_elems; i < 10 * config.max_elems; i++) {
+        TEST_ASSERT_NULL(oha_lpht_look_up(table, &i));
+    }
+
+    // removes of more than half of the elements rebuild the filter
+    for (uint64_t i = 0; i < config.max_elems; i += 2) {
+        TEST_ASSERT_NOT_NULL(oha_lpht_remove(table, &i));
+    }
+    for (uint64_t i = 0; i < config.max_elems; i++) {
+        uint64_t * value = oha_lpht_look_up(table, &i);
+        if (i % 2 == 0) {
+            TEST_ASSERT_NULL(value);
+        } else {
+            TEST_ASSERT_NOT_NULL(value);
+            TEST_ASSERT_EQUAL_UINT64(i, *value);
+        }
+    }
+
+    // churn with reinserts and erase_if
+    for (uint64_t i = 0; i < config.max_elems; i += 2) {
+        TEST_ASSERT_NOT_NULL(oha_lpht_insert(table, &i));
+    }
+    TEST_ASSERT_EQUAL_UINT32(config.max_elems / 2, oha_lpht_erase_if(table, is_even, NULL));
+    TEST_ASSERT_EQUAL_UINT32(config.max_elems / 2, oha_lpht_erase_if(table, is_odd, NULL));
+    for (uint64_t i = 0; i < config.max_elems; i++) {
+        TEST_ASSERT_NULL(oha_lpht_look_up(table, &i));
+    }
+
+    struct oha_lpht_statistics stats;
+    if (oha_lpht_get_statistics(table, &stats)) {
+        TEST_ASSERT_TRUE(stats.filter_rebuilds > 0);
+        TEST_ASSERT_TRUE(stats.filter_rejects > 0);
+        TEST_ASSERT_TRUE(stats.filter_rejects <= stats.misses);
+    }
+
+    oha_lpht_destroy(table);
+}
+
+void test_capacity_limits()
+{
+    struct oha_lpht_config config = {
+        .load_factor = 0.5,
+        .key_size = sizeof(uint64_t),
+        .value_size = sizeof(uint64_t),
+    };
+#ifdef OHA_WITH_64BIT_CAPACITY
+    TEST_ASSERT_EQUAL(sizeof(uint64_t), sizeof(oha_capacity_t));
+    // the bucket count fits, but not the memory size
+    config.max_elems = (oha_capacity_t)1 << 60;
+    TEST_ASSERT_EQUAL(0, oha_lpht_calculate_size(&config));
+    TEST_ASSERT_NULL(oha_lpht_create(&config));
+    config.max_elems = UINT64_MAX;
+    TEST_ASSERT_EQUAL(0, oha_lpht_calculate_size(&config));
+#else
+    TEST_ASSERT_EQUAL(sizeof(uint32_t), sizeof(oha_capacity_t));
+    // more buckets than the 32 bit offsets can address
+    config.max_elems = UINT32_MAX;
+    TEST_ASSERT_EQUAL(0, oha_lpht_calculate_size(&config));
+    TEST_ASSERT_NULL(oha_lpht_create(&config));
+#endif
+    config.max_elems = 1000;
+    config.filter_bits_per_elem = 64;
+    TEST_ASSERT_NOT_EQUAL(0, oha_lpht_calculate_size(&config));
+}
+
+static void check_look_up_batch_probe(uint32_t filter_bits_per_elem)
+{
+    const struct oha_lpht_config config = {
+        .load_factor = LOAF_FACTOR,
+        .key_size = sizeof(uint64_t),
+        .value_size = sizeof(uint64_t),
+        .max_elems = 1000,
+        .filter_bits_per_elem = filter_bits_per_elem,
+    };
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+    for (uint64_t i = 0; i < config.max_elems; i++) {
+        TEST_ASSERT_NOT_NULL(oha_lpht_insert(table, &i));
+    }
+
+    // every second key is missing, the count is no multiple of the group size
+    const size_t count = 2 * config.max_elems + 3;
+    uint64_t * keys = calloc(count, sizeof(uint64_t));
+    void ** values = calloc(count, sizeof(void *));
+    for (size_t i = 0; i < count; i++) {
+        keys[i] = i % 2 == 0 ? i / 2 : config.max_elems + i;
+    }
+    oha_lpht_look_up_batch(table, keys, count, values);
+    for (size_t i = 0; i < count; i++) {
+        TEST_ASSERT_EQUAL_PTR(oha_lpht_look_up(table, &keys[i]), values[i]);
+        if (i % 2 == 0 && keys[i] < config.max_elems) {
+            TEST_ASSERT_NOT_NULL(values[i]);
+        }
+
+        struct oha_lpht_probe probe;
+        TEST_ASSERT_NOT_NULL(oha_lpht_probe_init(table, &probe, &keys[i]));
+        void * value = (void *)1;
+        while (!oha_lpht_probe_step(table, &probe, &value)) {
+            TEST_ASSERT_NOT_NULL(probe.bucket);
+        }
+        TEST_ASSERT_EQUAL_PTR(values[i], value);
+    }
+    oha_lpht_look_up_batch(table, keys, 0, values);
+
+    free(keys);
+    free(values);
+    oha_lpht_destroy(table);
+}
+
+void test_look_up_batch_probe()
+{
+    check_look_up_batch_probe(0);
+    check_look_up_batch_probe(10);
+}
+
+static void check_clone(bool key_from_value, uint32_t filter_bits_per_elem)
+{
+    const struct oha_lpht_config config = {
+        .load_factor = LOAF_FACTOR,
+        .key_size = sizeof(uint64_t),
+        .value_size = sizeof(uint64_t),
+        .max_elems = 500,
+        .key_from_value = key_from_value,
+        .filter_bits_per_elem = filter_bits_per_elem,
+    };
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+    for (uint64_t i = 0; i < config.max_elems; i++) {
+        *(uint64_t *)oha_lpht_insert(table, &i) = i;
+    }
+    struct oha_lpht_status status;
+    TEST_ASSERT_TRUE(oha_lpht_get_status(table, &status));
+    TEST_ASSERT_EQUAL(oha_lpht_calculate_size(&config), status.size_in_bytes);
+
+    struct oha_lpht * clone = oha_lpht_clone(table, calloc(1, status.size_in_bytes));
+    struct oha_lpht * allocated_clone = oha_lpht_clone(table, NULL);
+    TEST_ASSERT_NOT_NULL(clone);
+    TEST_ASSERT_NOT_NULL(allocated_clone);
+
+    // the clones are independent of the source
+    for (uint64_t i = 0; i < config.max_elems; i += 2) {
+        TEST_ASSERT_NOT_NULL(oha_lpht_remove(table, &i));
+    }
+    oha_lpht_destroy(table);
+
+    for (uint64_t i = 0; i < config.max_elems; i++) {
+        uint64_t * value = oha_lpht_look_up(clone, &i);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_EQUAL_UINT64(i, *value);
+        if (key_from_value) {
+            TEST_ASSERT_EQUAL_UINT64(i, *(uint64_t *)oha_lpht_get_key_from_value(clone, value));
+        }
+        TEST_ASSERT_EQUAL_UINT64(i, *(uint64_t *)oha_lpht_look_up(allocated_clone, &i));
+    }
+    for (uint64_t i = 0; i < config.max_elems; i += 2) {
+        TEST_ASSERT_NOT_NULL(oha_lpht_remove(clone, &i));
+    }
+    for (uint64_t i = 0; i < config.max_elems; i++) {
+        TEST_ASSERT_EQUAL(i % 2 == 1, oha_lpht_look_up(clone, &i) != NULL);
+    }
+    TEST_ASSERT_NULL(oha_lpht_clone(NULL, NULL));
+
+    // the caller owns the memory of the clone
+    free(clone);
+    oha_lpht_destroy(allocated_clone);
+}
+
+void test_clone()
+{
+    check_clone(false, 0);
+    check_clone(true, 0);
+    check_clone(false, 8);
+}
+
+static void sum_counters(const void * key, void * dst_value, const void * src_value, void * context)
+{
+    (void)key;
+    *(uint64_t *)dst_value += *(const uint64_t *)src_value;
+    (*(uint32_t *)context)++;
+}
+
+void test_merge()
+{
+    struct oha_lpht_config config = {
+        .load_factor = LOAF_FACTOR,
+        .key_size = sizeof(uint64_t),
+        .value_size = sizeof(uint64_t),
+        .max_elems = 1000,
+    };
+    // keys 0..599 and 400..999 with counter 1
+    struct oha_lpht * a = oha_lpht_create(&config);
+    struct oha_lpht * b = oha_lpht_create(&config);
+    for (uint64_t i = 0; i < 600; i++) {
+        *(uint64_t *)oha_lpht_insert(a, &i) = 1;
+        uint64_t other = i + 400;
+        *(uint64_t *)oha_lpht_insert(b, &other) = 1;
+    }
+
+    config.key_from_value = true;
+    struct oha_lpht * dst = oha_lpht_create(&config);
+    uint32_t combined = 0;
+    TEST_ASSERT_TRUE(oha_lpht_merge(dst, a, sum_counters, &combined));
+    TEST_ASSERT_TRUE(oha_lpht_merge(dst, b, sum_counters, &combined));
+    TEST_ASSERT_EQUAL_UINT32(200, combined);
+    for (uint64_t i = 0; i < 1000; i++) {
+        uint64_t * value = oha_lpht_look_up(dst, &i);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_EQUAL_UINT64(i >= 400 && i < 600 ? 2 : 1, *value);
+        TEST_ASSERT_EQUAL_UINT64(i, *(uint64_t *)oha_lpht_get_key_from_value(dst, value));
+    }
+    // without combine the destination values are kept
+    TEST_ASSERT_TRUE(oha_lpht_merge(dst, a, NULL, NULL));
+    uint64_t key = 500;
+    TEST_ASSERT_EQUAL_UINT64(2, *(uint64_t *)oha_lpht_look_up(dst, &key));
+    TEST_ASSERT_FALSE(oha_lpht_merge(dst, dst, NULL, NULL));
+
+    // the destination is too small for the union
+    config.key_from_value = false;
+    config.max_elems = 700;
+    struct oha_lpht * small = oha_lpht_create(&config);
+    TEST_ASSERT_TRUE(oha_lpht_merge(small, a, NULL, NULL));
+    TEST_ASSERT_FALSE(oha_lpht_merge(small, b, NULL, NULL));
+
+    // different value sizes
+    config.value_size = 2 * sizeof(uint64_t);
+    struct oha_lpht * wide = oha_lpht_create(&config);
+    TEST_ASSERT_FALSE(oha_lpht_merge(wide, a, NULL, NULL));
+
+    // disjoint hash ranges
+    config.value_size = sizeof(uint64_t);
+    config.max_elems = 1000;
+    struct oha_lpht * partitions[4];
+    oha_capacity_t elems = 0;
+    for (uint32_t p = 0; p < 4; p++) {
+        partitions[p] = oha_lpht_create(&config);
+        TEST_ASSERT_TRUE(oha_lpht_merge_partition(partitions[p], a, sum_counters, &combined, p, 4));
+        TEST_ASSERT_TRUE(oha_lpht_merge_partition(partitions[p], b, sum_counters, &combined, p, 4));
+        struct oha_lpht_status status;
+        oha_lpht_get_status(partitions[p], &status);
+        elems += status.elems_in_use;
+    }
+    TEST_ASSERT_FALSE(oha_lpht_merge_partition(partitions[0], a, NULL, NULL, 4, 4));
+    TEST_ASSERT_EQUAL_UINT32(1000, elems);
+    for (uint64_t i = 0; i < 1000; i++) {
+        uint32_t p = oha_lpht_get_partition(dst, &i, 4);
+        uint64_t * value = oha_lpht_look_up(partitions[p], &i);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_EQUAL_UINT64(*(uint64_t *)oha_lpht_look_up(dst, &i), *value);
+    }
+
+    // the partitions do not depend on the seeds of the source and destination tables
+    config.seed = 7;
+    struct oha_lpht * seeded = oha_lpht_create(&config);
+    for (uint64_t i = 0; i < 1000; i++) {
+        *(uint64_t *)oha_lpht_insert(seeded, &i) = i;
+    }
+    struct oha_lpht * seeded_partitions[4];
+    elems = 0;
+    for (uint32_t p = 0; p < 4; p++) {
+        config.seed = p == 0 ? 0 : 100 + p;
+        seeded_partitions[p] = oha_lpht_create(&config);
+        TEST_ASSERT_TRUE(oha_lpht_merge_partition(seeded_partitions[p], seeded, NULL, NULL, p, 4));
+        struct oha_lpht_status status;
+        oha_lpht_get_status(seeded_partitions[p], &status);
+        elems += status.elems_in_use;
+    }
+    TEST_ASSERT_EQUAL_UINT32(1000, elems);
+    for (uint64_t i = 0; i < 1000; i++) {
+        uint32_t p = oha_lpht_get_partition(seeded, &i, 4);
+        TEST_ASSERT_EQUAL_UINT32(oha_lpht_get_partition(dst, &i, 4), p);
+        TEST_ASSERT_EQUAL_UINT32(oha_lpht_get_partition(seeded_partitions[(p + 1) % 4], &i, 4), p);
+        uint64_t * value = oha_lpht_look_up(seeded_partitions[p], &i);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_EQUAL_UINT64(i, *value);
+    }
+
+    for (uint32_t p = 0; p < 4; p++) {
+        oha_lpht_destroy(seeded_partitions[p]);
+        oha_lpht_destroy(partitions[p]);
+    }
+    oha_lpht_destroy(seeded);
+    oha_lpht_destroy(wide);
+    oha_lpht_destroy(small);
+    oha_lpht_destroy(dst);
+    oha_lpht_destroy(b);
+    oha_lpht_destroy(a);
+}
+
+static void check_rehash(bool key_from_value, uint32_t filter_bits_per_elem)
+{
+    struct oha_lpht_config config = {
+        .load_factor = LOAF_FACTOR,
+        .key_size = sizeof(uint64_t),
+        .value_size = sizeof(uint64_t),
+        .max_elems = 1000,
+        .key_from_value = key_from_value,
+        .filter_bits_per_elem = filter_bits_per_elem,
+    };
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+    for (uint64_t i = 0; i < config.max_elems; i++) {
+        *(uint64_t *)oha_lpht_insert(table, &i) = i;
+    }
+    for (uint64_t i = 100; i < config.max_elems; i++) {
+        TEST_ASSERT_NOT_NULL(oha_lpht_remove(table, &i));
+    }
+    struct oha_lpht_status status;
+    TEST_ASSERT_TRUE(oha_lpht_get_status(table, &status));
+    const size_t old_size = status.size_in_bytes;
+
+    // the elements do not fit, the table stays usable
+    TEST_ASSERT_NULL(oha_lpht_rehash(table, 99, 0.0));
+    table = oha_lpht_rehash(table, 200, 0.5);
+    TEST_ASSERT_NOT_NULL(table);
+    TEST_ASSERT_TRUE(oha_lpht_get_status(table, &status));
+    TEST_ASSERT_EQUAL_UINT32(200, status.max_elems);
+    TEST_ASSERT_EQUAL_UINT32(100, status.elems_in_use);
+    TEST_ASSERT_TRUE(status.size_in_bytes < old_size);
+    for (uint64_t i = 0; i < config.max_elems; i++) {
+        uint64_t * value = oha_lpht_look_up(table, &i);
+        if (i < 100) {
+            TEST_ASSERT_NOT_NULL(value);
+            TEST_ASSERT_EQUAL_UINT64(i, *value);
+            if (key_from_value) {
+                TEST_ASSERT_EQUAL_UINT64(i, *(uint64_t *)oha_lpht_get_key_from_value(table, value));
+            }
+        } else {
+            TEST_ASSERT_NULL(value);
+        }
+    }
+
+    // the new table is full usable with its own capacity
+    for (uint64_t i = 100; i < 200; i++) {
+        TEST_ASSERT_NOT_NULL(oha_lpht_insert(table, &i));
+    }
+    uint64_t key = 200;
+    TEST_ASSERT_NULL(oha_lpht_insert(table, &key));
+    oha_lpht_destroy(table);
+}
+
+void test_rehash()
+{
+    check_rehash(false, 0);
+    check_rehash(true, 0);
+    check_rehash(false, 8);
+    TEST_ASSERT_NULL(oha_lpht_rehash(NULL, 1, 0.0));
+}
+
+void test_rehash_caller_memory()
+{
+    const struct oha_lpht_config config = {
+        .load_factor = LOAF_FACTOR,
+        .key_size = sizeof(uint64_t),
+        .value_size = sizeof(uint64_t),
+        .max_elems = 100,
+        .shrink_threshold = 0.25,
+    };
+    void * memory = calloc(1, oha_lpht_calculate_size(&config));
+    struct oha_lpht * table = oha_lpht_initialize(&config, memory);
+    TEST_ASSERT_NOT_NULL(table);
+    uint64_t key = 1;
+    TEST_ASSERT_NOT_NULL(oha_lpht_insert(table, &key));
+
+    // the library must not release memory it did not allocate
+    TEST_ASSERT_NULL(oha_lpht_rehash(table, 200, 0.0));
+    TEST_ASSERT_EQUAL_PTR(table, oha_lpht_auto_shrink(table));
+
+    struct oha_lpht_status status;
+    TEST_ASSERT_TRUE(oha_lpht_get_status(table, &status));
+    void * clone_memory = calloc(1, status.size_in_bytes);
+    struct oha_lpht * clone = oha_lpht_clone(table, clone_memory);
+    TEST_ASSERT_NOT_NULL(clone);
+    TEST_ASSERT_NULL(oha_lpht_rehash(clone, 200, 0.0));
+
+    // an allocated clone owns its memory
+    struct oha_lpht * allocated_clone = oha_lpht_clone(table, NULL);
+    allocated_clone = oha_lpht_rehash(allocated_clone, 200, 0.0);
+    TEST_ASSERT_NOT_NULL(allocated_clone);
+    TEST_ASSERT_NOT_NULL(oha_lpht_look_up(allocated_clone, &key));
+    oha_lpht_destroy(allocated_clone);
+
+    TEST_ASSERT_NOT_NULL(oha_lpht_look_up(table, &key));
+    TEST_ASSERT_NOT_NULL(oha_lpht_look_up(clone, &key));
+    free(clone_memory);
+    free(memory);
+}
+
+void test_auto_shrink()
+{
+    struct oha_lpht_config config = {
+        .load_factor = LOAF_FACTOR,
+        .key_size = sizeof(uint64_t),
+        .value_size = sizeof(uint64_t),
+        .max_elems = 1000,
+        .shrink_threshold = 0.5,
+    };
+    TEST_ASSERT_NULL(oha_lpht_create(&config));
+    config.shrink_threshold = 0.25;
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+    for (uint64_t i = 0; i < 300; i++) {
+        oha_lpht_insert(table, &i);
+    }
+    TEST_ASSERT_EQUAL_PTR(table, oha_lpht_auto_shrink(table));
+    for (uint64_t i = 0; i < 100; i++) {
+        oha_lpht_remove(table, &i);
+    }
+    table = oha_lpht_auto_shrink(table);
+    struct oha_lpht_status status;
+    TEST_ASSERT_TRUE(oha_lpht_get_status(table, &status));
+    TEST_ASSERT_EQUAL_UINT32(400, status.max_elems);
+    TEST_ASSERT_EQUAL_UINT32(200, status.elems_in_use);
+    // the shrunk table is half full and keeps its size
+    TEST_ASSERT_EQUAL_PTR(table, oha_lpht_auto_shrink(table));
+    oha_lpht_destroy(table);
+
+    // disabled by default
+    config.shrink_threshold = 0.0;
+    table = oha_lpht_create(&config);
+    TEST_ASSERT_EQUAL_PTR(table, oha_lpht_auto_shrink(table));
+    oha_lpht_destroy(table);
+}
+
+// collects keys with the same start bucket in table, like a hash flooding attack against a known seed
+static size_t find_colliding_keys(struct oha_lpht * table, uint64_t * keys, size_t count)
+{
+    struct oha_lpht_probe probe;
+    uint64_t key = 0;
+    const void * bucket = oha_lpht_probe_init(table, &probe, &key);
+    size_t n = 0;
+    for (key = 0; n < count && key < 10000000; key++) {
+        if (oha_lpht_probe_init(table, &probe, &key) == bucket) {
+            keys[n++] = key;
+        }
+    }
+    return n;
+}
+
+void test_seed()
+{
+    struct oha_lpht_config config = {
+        .load_factor = LOAF_FACTOR,
+        .key_size = sizeof(uint64_t),
+        .value_size = sizeof(uint64_t),
+        .max_elems = 900,
+    };
+    struct oha_lpht * table = oha_lpht_create(&config);
+    uint64_t keys[100];
+    TEST_ASSERT_EQUAL(100, find_colliding_keys(table, keys, 100));
+
+    // the colliding keys spread over the buckets of a table with another seed
+    config.seed = 42;
+    struct oha_lpht * seeded = oha_lpht_create(&config);
+    struct oha_lpht_probe probe;
+    const void * bucket = oha_lpht_probe_init(seeded, &probe, &keys[0]);
+    size_t same_bucket = 0;
+    for (size_t i = 1; i < 100; i++) {
+        same_bucket += oha_lpht_probe_init(seeded, &probe, &keys[i]) == bucket;
+    }
+    TEST_ASSERT_TRUE(same_bucket < 5);
+
+    // the seed is kept by rehashes
+    for (size_t i = 0; i < 100; i++) {
+        *(uint64_t *)oha_lpht_insert(seeded, &keys[i]) = keys[i];
+    }
+    seeded = oha_lpht_rehash(seeded, 500, 0.0);
+    TEST_ASSERT_NOT_NULL(seeded);
+    for (size_t i = 0; i < 100; i++) {
+        uint64_t * value = oha_lpht_look_up(seeded, &keys[i]);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_EQUAL_UINT64(keys[i], *value);
+    }
+    // without a reseed_probe_length, the table is never reseeded
+    TEST_ASSERT_EQUAL_PTR(seeded, oha_lpht_auto_reseed(seeded));
+    oha_lpht_destroy(seeded);
+    oha_lpht_destroy(table);
+}
+
+void test_auto_reseed()
+{
+    const struct oha_lpht_config config = {
+        .load_factor = LOAF_FACTOR,
+        .key_size = sizeof(uint64_t),
+        .value_size = sizeof(uint64_t),
+        .max_elems = 900,
+        .reseed_probe_length = 32,
+    };
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+    uint64_t keys[100];
+    TEST_ASSERT_EQUAL(100, find_colliding_keys(table, keys, 100));
+
+    // short clusters are no attack
+    for (size_t i = 0; i < 32; i++) {
+        *(uint64_t *)oha_lpht_insert(table, &keys[i]) = keys[i];
+    }
+    TEST_ASSERT_EQUAL_PTR(table, oha_lpht_auto_reseed(table));
+
+    for (size_t i = 32; i < 100; i++) {
+        *(uint64_t *)oha_lpht_insert(table, &keys[i]) = keys[i];
+    }
+    struct oha_lpht * reseeded = oha_lpht_auto_reseed(table);
+    TEST_ASSERT_NOT_NULL(reseeded);
+    TEST_ASSERT_NOT_EQUAL(table, reseeded);
+    table = reseeded;
+
+    struct oha_lpht_status status;
+    TEST_ASSERT_TRUE(oha_lpht_get_status(table, &status));
+    TEST_ASSERT_EQUAL_UINT32(900, status.max_elems);
+    TEST_ASSERT_EQUAL_UINT32(100, status.elems_in_use);
+    for (size_t i = 0; i < 100; i++) {
+        uint64_t * value = oha_lpht_look_up(table, &keys[i]);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_EQUAL_UINT64(keys[i], *value);
+    }
+    // the keys do not collide under the new seed
+    TEST_ASSERT_EQUAL_PTR(table, oha_lpht_auto_reseed(table));
+    struct oha_lpht_statistics statistics;
+    if (oha_lpht_get_statistics(table, &statistics)) {
+        TEST_ASSERT_EQUAL_UINT64(1, statistics.reseeds);
+    }
+    oha_lpht_destroy(table);
+    TEST_ASSERT_NULL(oha_lpht_auto_reseed(NULL));
+
+    // the library must not release memory it did not allocate
+    void * memory = calloc(1, oha_lpht_calculate_size(&config));
+    table = oha_lpht_initialize(&config, memory);
+    TEST_ASSERT_NOT_NULL(table);
+    TEST_ASSERT_EQUAL(100, find_colliding_keys(table, keys, 100));
+    for (size_t i = 0; i < 100; i++) {
+        *(uint64_t *)oha_lpht_insert(table, &keys[i]) = keys[i];
+    }
+    TEST_ASSERT_EQUAL_PTR(table, oha_lpht_auto_reseed(table));
+    for (size_t i = 0; i < 100; i++) {
+        TEST_ASSERT_NOT_NULL(oha_lpht_look_up(table, &keys[i]));
+    }
+    free(memory);
+}
+
+void test_auto_reseed_stash()
+{
+    // no insert probes more than reseed_probe_length buckets, the colliding keys go into the stash
+    const struct oha_lpht_config config = {
+        .load_factor = LOAF_FACTOR,
+        .key_size = sizeof(uint64_t),
+        .value_size = sizeof(uint64_t),
+        .max_elems = 900,
+        .reseed_probe_length = 32,
+        .max_probe = 8,
+    };
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+    uint64_t keys[24];
+    TEST_ASSERT_EQUAL(24, find_colliding_keys(table, keys, 24));
+
+    // a few stashed keys are no attack
+    for (size_t i = 0; i < 23; i++) {
+        *(uint64_t *)oha_lpht_insert(table, &keys[i]) = keys[i];
+    }
+    struct oha_lpht_status status;
+    TEST_ASSERT_TRUE(oha_lpht_get_status(table, &status));
+    TEST_ASSERT_EQUAL_UINT32(15, status.stash_in_use);
+    TEST_ASSERT_EQUAL_PTR(table, oha_lpht_auto_reseed(table));
+
+    // the half full stash marks the table
+    *(uint64_t *)oha_lpht_insert(table, &keys[23]) = keys[23];
+    struct oha_lpht * reseeded = oha_lpht_auto_reseed(table);
+    TEST_ASSERT_NOT_NULL(reseeded);
+    TEST_ASSERT_NOT_EQUAL(table, reseeded);
+    table = reseeded;
+    TEST_ASSERT_TRUE(oha_lpht_get_status(table, &status));
+    TEST_ASSERT_EQUAL_UINT32(24, status.elems_in_use);
+    TEST_ASSERT_TRUE(status.stash_in_use < 16);
+    for (size_t i = 0; i < 24; i++) {
+        uint64_t * value = oha_lpht_look_up(table, &keys[i]);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_EQUAL_UINT64(keys[i], *value);
+    }
+    oha_lpht_destroy(table);
+}
+
+static void check_max_probe(uint32_t filter_bits_per_elem)
+{
+    const struct oha_lpht_config config = {
+        .load_factor = LOAF_FACTOR,
+        .key_size = sizeof(uint64_t),
+        .value_size = sizeof(uint64_t),
+        .max_elems = 900,
+        .filter_bits_per_elem = filter_bits_per_elem,
+        .max_probe = 4,
+    };
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+    uint64_t keys[37];
+    TEST_ASSERT_EQUAL(37, find_colliding_keys(table, keys, 37));
+
+    // 4 keys in the probed buckets and 32 keys in the stash, then the stash is full
+    for (size_t i = 0; i < 36; i++) {
+        bool inserted = false;
+        uint64_t * value = oha_lpht_insert_ex(table, &keys[i], &inserted);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_TRUE(inserted);
+        *value = keys[i];
+    }
+    TEST_ASSERT_NULL(oha_lpht_insert(table, &keys[36]));
+    struct oha_lpht_status status;
+    TEST_ASSERT_TRUE(oha_lpht_get_status(table, &status));
+    TEST_ASSERT_EQUAL_UINT32(36, status.elems_in_use);
+    TEST_ASSERT_EQUAL_UINT32(3, status.max_probe_distance);
+    TEST_ASSERT_EQUAL_UINT32(32, status.stash_in_use);
+    TEST_ASSERT_EQUAL_UINT32(32, status.stash_size);
+
+    void * values[36];
+    oha_lpht_look_up_batch(table, keys, 36, values);
+    for (size_t i = 0; i < 36; i++) {
+        uint64_t * value = oha_lpht_look_up(table, &keys[i]);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_EQUAL_UINT64(keys[i], *value);
+        TEST_ASSERT_EQUAL_PTR(value, values[i]);
+
+        struct oha_lpht_probe probe;
+        oha_lpht_probe_init(table, &probe, &keys[i]);
+        void * probed = NULL;
+        while (!oha_lpht_probe_step(table, &probe, &probed)) {
+        }
+        TEST_ASSERT_EQUAL_PTR(value, probed);
+    }
+    TEST_ASSERT_NULL(oha_lpht_look_up(table, &keys[36]));
+
+    // a free probed bucket does not duplicate a stashed key
+    TEST_ASSERT_NOT_NULL(oha_lpht_remove(table, &keys[0]));
+    bool inserted = true;
+    TEST_ASSERT_EQUAL_PTR(values[35], oha_lpht_insert_ex(table, &keys[35], &inserted));
+    TEST_ASSERT_FALSE(inserted);
+
+    // removed stash keys free their bucket
+    TEST_ASSERT_EQUAL_PTR(values[20], oha_lpht_remove(table, &keys[20]));
+    TEST_ASSERT_NULL(oha_lpht_look_up(table, &keys[20]));
+    TEST_ASSERT_NULL(oha_lpht_remove(table, &keys[20]));
+    TEST_ASSERT_NOT_NULL(oha_lpht_insert(table, &keys[36]));
+    TEST_ASSERT_NOT_NULL(oha_lpht_insert(table, &keys[0]));
+    TEST_ASSERT_TRUE(oha_lpht_get_status(table, &status));
+    TEST_ASSERT_EQUAL_UINT32(36, status.elems_in_use);
+    TEST_ASSERT_EQUAL_UINT32(32, status.stash_in_use);
+
+    // iterations cover the stash
+    size_t position = 0;
+    size_t found = 0;
+    size_t even = 0;
+    for (struct oha_key_value_pair pair = oha_lpht_get_next_element(table, &position); pair.key != NULL;
+         pair = oha_lpht_get_next_element(table, &position)) {
+        found++;
+        even += *(const uint64_t *)pair.key % 2 == 0;
+    }
+    TEST_ASSERT_EQUAL(36, found);
+
+    // the clone and the rehashed table find all keys
+    struct oha_lpht * clone = oha_lpht_clone(table, NULL);
+    TEST_ASSERT_NOT_NULL(clone);
+    table = oha_lpht_rehash(table, 1800, 0.0);
+    TEST_ASSERT_NOT_NULL(table);
+    for (size_t i = 0; i < 37; i++) {
+        if (i == 20) {
+            continue;
+        }
+        TEST_ASSERT_NOT_NULL(oha_lpht_look_up(clone, &keys[i]));
+        TEST_ASSERT_NOT_NULL(oha_lpht_look_up(table, &keys[i]));
+    }
+    TEST_ASSERT_EQUAL_UINT32(even, oha_lpht_erase_if(clone, is_even, NULL));
+    TEST_ASSERT_EQUAL_UINT32(36 - even, oha_lpht_erase_if(clone, is_odd, NULL));
+    TEST_ASSERT_TRUE(oha_lpht_get_status(clone, &status));
+    TEST_ASSERT_EQUAL_UINT32(0, status.elems_in_use);
+    TEST_ASSERT_EQUAL_UINT32(0, status.stash_in_use);
+    for (size_t i = 0; i < 37; i++) {
+        TEST_ASSERT_NULL(oha_lpht_look_up(clone, &keys[i]));
+    }
+    oha_lpht_destroy(clone);
+    oha_lpht_destroy(table);
+}
+
+void test_max_probe()
+{
+    check_max_probe(0);
+    check_max_probe(10);
+
+    // unbounded tables have no stash
+    const struct oha_lpht_config config = {
+        .load_factor = LOAF_FACTOR,
+        .key_size = sizeof(uint64_t),
+        .value_size = sizeof(uint64_t),
+        .max_elems = 100,
+    };
+    struct oha_lpht * table = oha_lpht_create(&config);
+    struct oha_lpht_status status;
+    TEST_ASSERT_TRUE(oha_lpht_get_status(table, &status));
+    TEST_ASSERT_EQUAL_UINT32(0, status.stash_size);
+    TEST_ASSERT_EQUAL_UINT32(0, status.max_probe_distance);
+    oha_lpht_destroy(table);
+}
+
+static void check_prepare_insert(uint32_t filter_bits_per_elem, uint32_t max_probe)
+{
+    const struct oha_lpht_config config = {
+        .load_factor = LOAF_FACTOR,
+        .key_size = sizeof(uint64_t),
+        .value_size = sizeof(uint64_t),
+        .max_elems = 900,
+        .key_from_value = true,
+        .filter_bits_per_elem = filter_bits_per_elem,
+        .max_probe = max_probe,
+    };
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+    // colliding keys reach the stash of max_probe tables
+    uint64_t keys[20];
+    TEST_ASSERT_EQUAL(20, find_colliding_keys(table, keys, 20));
+
+    struct oha_lpht_slot slot;
+    for (size_t i = 0; i < 20; i++) {
+        uint64_t * value = oha_lpht_prepare_insert(table, &keys[i], &slot);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_NOT_NULL(slot.bucket);
+        *value = keys[i];
+        // reserved keys are not visible
+        TEST_ASSERT_NULL(oha_lpht_look_up(table, &keys[i]));
+        if (i % 2 == 1) {
+            oha_lpht_abort_insert(table, &slot);
+            TEST_ASSERT_NULL(slot.bucket);
+            TEST_ASSERT_NULL(oha_lpht_commit_insert(table, &slot));
+            continue;
+        }
+        TEST_ASSERT_EQUAL_PTR(value, oha_lpht_commit_insert(table, &slot));
+        TEST_ASSERT_EQUAL_PTR(value, oha_lpht_look_up(table, &keys[i]));
+        TEST_ASSERT_EQUAL_UINT64(keys[i], *(uint64_t *)oha_lpht_get_key_from_value(table, value));
+    }
+
+    struct oha_lpht_status status;
+    TEST_ASSERT_TRUE(oha_lpht_get_status(table, &status));
+    TEST_ASSERT_EQUAL_UINT32(10, status.elems_in_use);
+    for (size_t i = 0; i < 20; i++) {
+        uint64_t * value = oha_lpht_look_up(table, &keys[i]);
+        if (i % 2 == 1) {
+            TEST_ASSERT_NULL(value);
+            continue;
+        }
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_EQUAL_UINT64(keys[i], *value);
+        // inserted keys are found without a reservation
+        TEST_ASSERT_EQUAL_PTR(value, oha_lpht_prepare_insert(table, &keys[i], &slot));
+        TEST_ASSERT_NULL(slot.bucket);
+        TEST_ASSERT_NULL(oha_lpht_commit_insert(table, &slot));
+        TEST_ASSERT_NOT_NULL(oha_lpht_remove(table, &keys[i]));
+    }
+    TEST_ASSERT_TRUE(oha_lpht_get_status(table, &status));
+    TEST_ASSERT_EQUAL_UINT32(0, status.elems_in_use);
+    TEST_ASSERT_EQUAL_UINT32(0, status.stash_in_use);
+    oha_lpht_destroy(table);
+}
+
+void test_prepare_insert()
+{
+    check_prepare_insert(0, 0);
+    check_prepare_insert(10, 0);
+    check_prepare_insert(0, 4);
+    check_prepare_insert(10, 4);
+
+    const struct oha_lpht_config config = {
+        .load_factor = LOAF_FACTOR,
+        .key_size = sizeof(uint64_t),
+        .value_size = sizeof(uint64_t),
+        .max_elems = 10,
+    };
+    struct oha_lpht * table = oha_lpht_create(&config);
+    struct oha_lpht_slot slot;
+    for (uint64_t i = 0; i < config.max_elems; i++) {
+        TEST_ASSERT_NOT_NULL(oha_lpht_prepare_insert(table, &i, &slot));
+        TEST_ASSERT_NOT_NULL(oha_lpht_commit_insert(table, &slot));
+    }
+    // full table
+    uint64_t key = config.max_elems;
+    TEST_ASSERT_NULL(oha_lpht_prepare_insert(table, &key, &slot));
+    TEST_ASSERT_NULL(slot.bucket);
+    TEST_ASSERT_NULL(oha_lpht_prepare_insert(NULL, &key, &slot));
+    TEST_ASSERT_NULL(oha_lpht_prepare_insert(table, NULL, &slot));
+    TEST_ASSERT_NULL(oha_lpht_prepare_insert(table, &key, NULL));
+    oha_lpht_abort_insert(table, NULL);
+
+    // prepared inserts probe without counting look ups
+    struct oha_lpht_statistics statistics;
+    if (oha_lpht_get_statistics(table, &statistics)) {
+        TEST_ASSERT_EQUAL_UINT64(0, statistics.look_ups);
+        TEST_ASSERT_EQUAL_UINT64(0, statistics.hits + statistics.misses);
+        TEST_ASSERT_TRUE(statistics.probe_steps > 0);
+    }
+    oha_lpht_destroy(table);
+}
+
+struct long_key {
+    uint64_t id;
+    uint8_t payload[56];
+};
+
+void test_cache_hashes()
+{
+    struct oha_lpht_config config = {
+        .load_factor = LOAF_FACTOR,
+        .key_size = sizeof(struct long_key),
+        .value_size = sizeof(uint64_t),
+        .max_elems = 1000,
+        .cache_hashes = true,
+        .filter_bits_per_elem = 8,
+    };
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+    struct long_key key = {0};
+    for (key.id = 0; key.id < config.max_elems; key.id++) {
+        *(uint64_t *)oha_lpht_insert(table, &key) = key.id;
+    }
+    // removes and erase_if move keys with their hashes, the filter rebuild reads the hashes
+    for (key.id = 0; key.id < config.max_elems; key.id += 3) {
+        TEST_ASSERT_NOT_NULL(oha_lpht_remove(table, &key));
+    }
+    TEST_ASSERT_EQUAL_UINT32(333, oha_lpht_erase_if(table, is_even, NULL));
+    oha_lpht_reset_statistics(table);
+    for (key.id = 0; key.id < config.max_elems; key.id++) {
+        uint64_t * value = oha_lpht_look_up(table, &key);
+        if (key.id % 3 == 0 || key.id % 2 == 0) {
+            TEST_ASSERT_NULL(value);
+        } else {
+            TEST_ASSERT_NOT_NULL(value);
+            TEST_ASSERT_EQUAL_UINT64(key.id, *value);
+        }
+    }
+    // buckets with other hashes are skipped without comparing their keys
+    struct oha_lpht_statistics stats;
+    if (oha_lpht_get_statistics(table, &stats)) {
+        TEST_ASSERT_EQUAL_UINT64(stats.hits, stats.key_compares);
+    }
+
+    // rehash and merge into a table without cached hashes
+    table = oha_lpht_rehash(table, 400, 0.0);
+    TEST_ASSERT_NOT_NULL(table);
+    config.cache_hashes = false;
+    struct oha_lpht * plain = oha_lpht_create(&config);
+    TEST_ASSERT_TRUE(oha_lpht_merge(plain, table, NULL, NULL));
+    for (key.id = 0; key.id < config.max_elems; key.id++) {
+        bool expected = key.id % 3 != 0 && key.id % 2 != 0;
+        uint64_t * value = oha_lpht_look_up(table, &key);
+        TEST_ASSERT_EQUAL(expected, value != NULL);
+        TEST_ASSERT_EQUAL(expected, oha_lpht_look_up(plain, &key) != NULL);
+        if (expected) {
+            TEST_ASSERT_EQUAL_UINT64(key.id, *value);
+        }
+    }
+    oha_lpht_destroy(plain);
+    oha_lpht_destroy(table);
+}
+
+void test_add_u64()
+{
+    struct oha_lpht_config config = {
+        .load_factor = LOAF_FACTOR,
+        .key_size = sizeof(uint64_t),
+        .value_size = sizeof(uint64_t),
+        .max_elems = 100,
+    };
+    struct oha_lpht * table = oha_lpht_create(&config);
+    uint64_t key = 7;
+    TEST_ASSERT_EQUAL_UINT64(5, *oha_lpht_add_u64(table, &key, 5));
+    TEST_ASSERT_EQUAL_UINT64(8, *oha_lpht_add_u64(table, &key, 3));
+
+    // repeated keys inside and across the batch groups
+    uint64_t keys[1000];
+    uint64_t deltas[1000];
+    for (size_t i = 0; i < 1000; i++) {
+        keys[i] = i % 100;
+        deltas[i] = i;
+    }
+    TEST_ASSERT_EQUAL_size_t(1000, oha_lpht_add_u64_batch(table, keys, NULL, 1000));
+    TEST_ASSERT_EQUAL_size_t(1000, oha_lpht_add_u64_batch(table, keys, deltas, 1000));
+    for (uint64_t i = 0; i < 100; i++) {
+        // 10 counts and the sum of i, i + 100, ..., i + 900
+        uint64_t expected = 10 + 10 * i + 4500 + (i == 7 ? 8 : 0);
+        TEST_ASSERT_EQUAL_UINT64(expected, *(uint64_t *)oha_lpht_look_up(table, &i));
+    }
+
+    // the table gets full in the middle of the batch
+    for (size_t i = 0; i < 20; i++) {
+        keys[i] = i < 10 ? i : 1000 + i;
+    }
+    TEST_ASSERT_EQUAL_size_t(10, oha_lpht_add_u64_batch(table, keys, NULL, 20));
+    key = 1000;
+    TEST_ASSERT_NULL(oha_lpht_add_u64(table, &key, 1));
+    oha_lpht_destroy(table);
+
+    // only 8 byte values
+    config.value_size = sizeof(uint32_t);
+    table = oha_lpht_create(&config);
+    TEST_ASSERT_NULL(oha_lpht_add_u64(table, &key, 1));
+    TEST_ASSERT_EQUAL_size_t(0, oha_lpht_add_u64_batch(table, keys, NULL, 20));
+    oha_lpht_destroy(table);
+}
+
 int main(void)
 {
     UNITY_BEGIN();
@@ -176,6 +1363,26 @@ int main(void)
     RUN_TEST(test_insert_look_up);
     RUN_TEST(test_insert_look_up_remove);
     RUN_TEST(test_clear_remove);
+    RUN_TEST(test_insert_ex);
+    RUN_TEST(test_erase_if);
+    RUN_TEST(test_key_from_value);
+    RUN_TEST(test_key_sizes);
+    RUN_TEST(test_statistics);
+    RUN_TEST(test_filter);
+    RUN_TEST(test_capacity_limits);
+    RUN_TEST(test_look_up_batch_probe);
+    RUN_TEST(test_clone);
+    RUN_TEST(test_merge);
+    RUN_TEST(test_rehash);
+    RUN_TEST(test_rehash_caller_memory);
+    RUN_TEST(test_auto_shrink);
+    RUN_TEST(test_seed);
+    RUN_TEST(test_auto_reseed);
+    RUN_TEST(test_auto_reseed_stash);
+    RUN_TEST(test_max_probe);
+    RUN_TEST(test_prepare_insert);
+    RUN_TEST(test_cache_hashes);
+    RUN_TEST(test_add_u64);
 
     return UNITY_END();
 }
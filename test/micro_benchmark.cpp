@@ -0,0 +1,737 @@
+#include <algorithm>
+#include <chrono>
+#include <oha.hpp>
+#include <pthread.h>
+#include <random>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+#define DEFAULT_ELEMENTS 4000000
+#define LOOK_UPS_PER_RUN 4000000
+
+/*
+ * Synthetic benchmarks of single features, every mode generates its own key set.
+ */
+
+struct value {
+    uint64_t array[1];
+};
+
+static double measure_look_ups(struct oha_lpht * table, const vector<uint64_t> & keys, uint64_t & found)
+{
+    found = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (uint64_t key : keys) {
+        found += oha_lpht_look_up(table, &key) != NULL;
+    }
+    chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+    return elapsed.count() / keys.size();
+}
+
+/*
+ * Sweeps the hit ratio of look ups into a table with and without bloom filter. Missing keys are never inserted, so
+ * the filter answers most of them without touching the table.
+ */
+static int run_filter(uint32_t elements)
+{
+    struct oha_lpht_config config = {};
+    config.load_factor = 0.7;
+    config.key_size = sizeof(uint64_t);
+    config.value_size = sizeof(struct value);
+    config.max_elems = elements;
+
+    struct oha_lpht_config filter_config = config;
+    filter_config.filter_bits_per_elem = 10;
+
+    struct oha_lpht * table = oha_lpht_create(&config);
+    struct oha_lpht * filter_table = oha_lpht_create(&filter_config);
+    if (table == NULL || filter_table == NULL) {
+        fprintf(stderr, "could not create the tables\n");
+        oha_lpht_destroy(table);
+        oha_lpht_destroy(filter_table);
+        return 1;
+    }
+    printf("elements: %u\nmemory:\n -lpht:\t\t%zu bytes\n -lpht+filter:\t%zu bytes\n",
+           elements,
+           oha_lpht_calculate_size(&config),
+           oha_lpht_calculate_size(&filter_config));
+
+    // odd keys are inserted, even keys are misses
+    mt19937_64 rng(42);
+    for (uint64_t i = 0; i < elements; i++) {
+        uint64_t key = 2 * i + 1;
+        memcpy(oha_lpht_insert(table, &key), &key, sizeof(key));
+        memcpy(oha_lpht_insert(filter_table, &key), &key, sizeof(key));
+    }
+
+    printf("hit ratio\tlpht ns/op\tfilter ns/op\tspeedup\n");
+    for (int percent = 0; percent <= 100; percent += 10) {
+        vector<uint64_t> keys(LOOK_UPS_PER_RUN);
+        uniform_int_distribution<uint64_t> index(0, elements - 1);
+        uniform_int_distribution<int> hit(0, 99);
+        for (uint64_t & key : keys) {
+            key = 2 * index(rng) + (hit(rng) < percent ? 1 : 0);
+        }
+
+        uint64_t found;
+        uint64_t filter_found;
+        double plain = measure_look_ups(table, keys, found);
+        double filtered = measure_look_ups(filter_table, keys, filter_found);
+        if (found != filter_found) {
+            fprintf(stderr, "result mismatch %lu vs. %lu\n", found, filter_found);
+            oha_lpht_destroy(table);
+            oha_lpht_destroy(filter_table);
+            return 1;
+        }
+        printf("%d%%\t\t%.2f\t\t%.2f\t\t%.2f\n", percent, plain, filtered, plain / filtered);
+    }
+
+    oha_lpht_destroy(table);
+    oha_lpht_destroy(filter_table);
+    return 0;
+}
+
+template <typename Func> static double measure_ns_per_op(size_t operations, Func func)
+{
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    func();
+    chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+    return elapsed.count() / operations;
+}
+
+/*
+ * Compares sequential look ups, the batch look up and coroutine interleaved look ups with different numbers of look ups
+ * in flight. All keys are hits in random order.
+ */
+static int run_interleaved(uint32_t elements)
+{
+    struct oha_lpht_config config = {};
+    config.load_factor = 0.7;
+    config.key_size = sizeof(uint64_t);
+    config.value_size = sizeof(uint64_t);
+    config.max_elems = elements;
+    oha::lpht<uint64_t, uint64_t> table(elements, config.load_factor);
+    printf("elements: %u\nmemory: %zu bytes\n", elements, oha_lpht_calculate_size(&config));
+
+    for (uint64_t key = 0; key < elements; key++) {
+        table.insert(key, key);
+    }
+    vector<uint64_t> keys(LOOK_UPS_PER_RUN);
+    mt19937_64 rng(42);
+    uniform_int_distribution<uint64_t> key(0, elements - 1);
+    for (uint64_t & k : keys) {
+        k = key(rng);
+    }
+
+    uint64_t sum = 0;
+    printf("method\t\t\tns/op\n");
+    double ns = measure_ns_per_op(keys.size(), [&]() {
+        for (uint64_t k : keys) {
+            sum += *table.find(k);
+        }
+    });
+    printf("sequential\t\t%.2f\n", ns);
+
+    vector<uint64_t *> values(keys.size());
+    ns = measure_ns_per_op(keys.size(), [&]() {
+        table.find_batch(keys.data(), keys.size(), values.data());
+        for (uint64_t * value : values) {
+            sum += *value;
+        }
+    });
+    printf("batch\t\t\t%.2f\n", ns);
+
+#ifdef OHA_WITH_COROUTINES
+    auto sum_values = [&](size_t, uint64_t * value) { sum += *value; };
+    ns = measure_ns_per_op(keys.size(), [&]() { oha::find_interleaved<4>(table, keys.data(), keys.size(), sum_values); });
+    printf("coroutines 4\t\t%.2f\n", ns);
+    ns = measure_ns_per_op(keys.size(), [&]() { oha::find_interleaved<8>(table, keys.data(), keys.size(), sum_values); });
+    printf("coroutines 8\t\t%.2f\n", ns);
+    ns = measure_ns_per_op(keys.size(), [&]() { oha::find_interleaved<16>(table, keys.data(), keys.size(), sum_values); });
+    printf("coroutines 16\t\t%.2f\n", ns);
+    ns = measure_ns_per_op(keys.size(), [&]() { oha::find_interleaved<32>(table, keys.data(), keys.size(), sum_values); });
+    printf("coroutines 32\t\t%.2f\n", ns);
+#else
+    printf("coroutines\t\tnot supported by the compiler\n");
+#endif
+    // keeps the look ups alive
+    printf("checksum: %lu\n", sum);
+    return 0;
+}
+
+#define MERGE_TABLES 32
+
+static void add_counter(const void * key, void * dst_value, const void * src_value, void * context)
+{
+    (void)key;
+    (void)context;
+    *(uint64_t *)dst_value += *(const uint64_t *)src_value;
+}
+
+/*
+ * Merges 32 partial aggregation tables with overlapping keys into one table, by reinsertion of the iterated elements,
+ * with oha_lpht_merge() and in parallel with oha_lpht_merge_partition() into one table per thread.
+ */
+static int run_merge(uint32_t elements)
+{
+    struct oha_lpht_config config = {};
+    config.load_factor = 0.7;
+    config.key_size = sizeof(uint64_t);
+    config.value_size = sizeof(uint64_t);
+    config.max_elems = elements / 8;
+
+    // every partial table counts random keys of the whole key range
+    vector<struct oha_lpht *> partials(MERGE_TABLES);
+    mt19937_64 rng(42);
+    uniform_int_distribution<uint64_t> key(0, elements - 1);
+    for (struct oha_lpht *& partial : partials) {
+        partial = oha_lpht_create(&config);
+        for (uint32_t i = 0; i < config.max_elems; i++) {
+            uint64_t k = key(rng);
+            bool inserted;
+            uint64_t * counter = (uint64_t *)oha_lpht_insert_ex(partial, &k, &inserted);
+            *counter = inserted ? 1 : *counter + 1;
+        }
+    }
+    config.max_elems = elements;
+    printf("partial tables: %d\nelements per partial table: %u\nkey range: %u\n", MERGE_TABLES, elements / 8, elements);
+    printf("method\t\t\tms\n");
+
+    struct oha_lpht * dst = oha_lpht_create(&config);
+    double ns = measure_ns_per_op(1, [&]() {
+        for (struct oha_lpht * partial : partials) {
+            size_t position = 0;
+            for (struct oha_key_value_pair pair = oha_lpht_get_next_element(partial, &position); pair.key != NULL;
+                 pair = oha_lpht_get_next_element(partial, &position)) {
+                bool inserted;
+                uint64_t * counter = (uint64_t *)oha_lpht_insert_ex(dst, pair.key, &inserted);
+                *counter = (inserted ? 0 : *counter) + *(uint64_t *)pair.value;
+            }
+        }
+    });
+    printf("reinsert\t\t%.2f\n", ns / 1e6);
+    oha_lpht_destroy(dst);
+
+    dst = oha_lpht_create(&config);
+    ns = measure_ns_per_op(1, [&]() {
+        for (struct oha_lpht * partial : partials) {
+            oha_lpht_merge(dst, partial, add_counter, NULL);
+        }
+    });
+    printf("merge\t\t\t%.2f\n", ns / 1e6);
+    oha_lpht_destroy(dst);
+
+    const uint32_t num_threads = max(1u, thread::hardware_concurrency());
+    struct oha_lpht_config partition_config = config;
+    partition_config.max_elems = elements / num_threads + elements / num_threads / 8 + 64;
+    vector<struct oha_lpht *> partitions(num_threads);
+    for (struct oha_lpht *& partition : partitions) {
+        partition = oha_lpht_create(&partition_config);
+    }
+    ns = measure_ns_per_op(1, [&]() {
+        vector<thread> threads;
+        for (uint32_t t = 0; t < num_threads; t++) {
+            threads.emplace_back([&, t]() {
+                for (struct oha_lpht * partial : partials) {
+                    oha_lpht_merge_partition(partitions[t], partial, add_counter, NULL, t, num_threads);
+                }
+            });
+        }
+        for (thread & t : threads) {
+            t.join();
+        }
+    });
+    printf("merge %u threads\t%.2f\n", num_threads, ns / 1e6);
+    for (struct oha_lpht * partition : partitions) {
+        oha_lpht_destroy(partition);
+    }
+
+    for (struct oha_lpht * partial : partials) {
+        oha_lpht_destroy(partial);
+    }
+    return 0;
+}
+
+#define AGGREGATE_ROWS 100000000
+#define AGGREGATE_CHUNK_ROWS (1 << 24) // the stream repeats a chunk of random rows
+
+/*
+ * SELECT key, SUM(value) GROUP BY key over a synthetic stream of rows with uniform random keys, elements is the number
+ * of groups.
+ */
+static int run_aggregate(uint32_t elements)
+{
+    vector<uint64_t> keys(AGGREGATE_CHUNK_ROWS);
+    vector<uint64_t> values(AGGREGATE_CHUNK_ROWS);
+    mt19937_64 rng(42);
+    uniform_int_distribution<uint64_t> random_key(0, elements - 1);
+    for (size_t i = 0; i < keys.size(); i++) {
+        keys[i] = random_key(rng);
+        values[i] = i & 0xff;
+    }
+    printf("rows: %d\ngroups: %u\n", AGGREGATE_ROWS, elements);
+    printf("method\t\t\tns per row\tchecksum\n");
+
+    // runs func(first row, number of rows) over the chunks of the stream
+    auto for_each_chunk = [&](auto func) {
+        for (size_t row = 0; row < AGGREGATE_ROWS; row += AGGREGATE_CHUNK_ROWS) {
+            func(0, min((size_t)AGGREGATE_CHUNK_ROWS, (size_t)AGGREGATE_ROWS - row));
+        }
+    };
+
+    {
+        unordered_map<uint64_t, uint64_t> umap;
+        umap.reserve(elements);
+        double ns = measure_ns_per_op(AGGREGATE_ROWS, [&]() {
+            for_each_chunk([&](size_t first, size_t n) {
+                for (size_t i = first; i < first + n; i++) {
+                    umap[keys[i]] += values[i];
+                }
+            });
+        });
+        uint64_t sum = 0;
+        for (const auto & group : umap) {
+            sum += group.first * group.second;
+        }
+        printf("std::unordered_map\t%.2f\t\t%lu\n", ns, sum);
+    }
+
+    struct oha_lpht_config config = {};
+    config.load_factor = 0.7;
+    config.key_size = sizeof(uint64_t);
+    config.value_size = sizeof(uint64_t);
+    config.max_elems = elements;
+    auto checksum = [](struct oha_lpht * table) {
+        uint64_t sum = 0;
+        size_t position = 0;
+        for (struct oha_key_value_pair pair = oha_lpht_get_next_element(table, &position); pair.key != NULL;
+             pair = oha_lpht_get_next_element(table, &position)) {
+            sum += *(uint64_t *)pair.key * *(uint64_t *)pair.value;
+        }
+        return sum;
+    };
+
+    struct oha_lpht * table = oha_lpht_create(&config);
+    double ns = measure_ns_per_op(AGGREGATE_ROWS, [&]() {
+        for_each_chunk([&](size_t first, size_t n) {
+            for (size_t i = first; i < first + n; i++) {
+                bool inserted;
+                uint64_t * value = (uint64_t *)oha_lpht_insert_ex(table, &keys[i], &inserted);
+                *value = (inserted ? 0 : *value) + values[i];
+            }
+        });
+    });
+    printf("oha_lpht_insert_ex\t%.2f\t\t%lu\n", ns, checksum(table));
+    oha_lpht_destroy(table);
+
+    table = oha_lpht_create(&config);
+    ns = measure_ns_per_op(AGGREGATE_ROWS, [&]() {
+        for_each_chunk([&](size_t first, size_t n) {
+            for (size_t i = first; i < first + n; i++) {
+                oha_lpht_add_u64(table, &keys[i], values[i]);
+            }
+        });
+    });
+    printf("oha_lpht_add_u64\t%.2f\t\t%lu\n", ns, checksum(table));
+    oha_lpht_destroy(table);
+
+    table = oha_lpht_create(&config);
+    ns = measure_ns_per_op(AGGREGATE_ROWS, [&]() {
+        for_each_chunk([&](size_t first, size_t n) {
+            oha_lpht_add_u64_batch(table, &keys[first], &values[first], n);
+        });
+    });
+    printf("oha_lpht_add_u64_batch\t%.2f\t\t%lu\n", ns, checksum(table));
+    oha_lpht_destroy(table);
+
+    // the same into cache sized partition tables
+    struct oha_rp_config rp_config = {};
+    rp_config.table = config;
+    struct oha_rp * rp = oha_rp_create(&rp_config);
+    if (rp == NULL) {
+        fprintf(stderr, "could not create radix partitions\n");
+        return 1;
+    }
+    ns = measure_ns_per_op(AGGREGATE_ROWS, [&]() {
+        for_each_chunk([&](size_t first, size_t n) {
+            oha_rp_partition(rp, &keys[first], &values[first], n);
+            for (uint32_t p = 0; p < oha_rp_get_num_partitions(rp); p++) {
+                const void * partition_keys;
+                const void * partition_values;
+                size_t rows = oha_rp_get_rows(rp, p, &partition_keys, &partition_values);
+                oha_lpht_add_u64_batch(
+                    oha_rp_get_table(rp, p), partition_keys, (const uint64_t *)partition_values, rows);
+            }
+        });
+    });
+    uint64_t sum = 0;
+    for (uint32_t p = 0; p < oha_rp_get_num_partitions(rp); p++) {
+        sum += checksum(oha_rp_get_table(rp, p));
+    }
+    printf("radix %u partitions\t%.2f\t\t%lu\n", oha_rp_get_num_partitions(rp), ns, sum);
+    oha_rp_destroy(rp);
+    return 0;
+}
+
+#define JOIN_SUPPLIERS_PER_PART 4
+#define JOIN_OUTPUT_SIZE 4096
+
+/*
+ * TPC-H like join of lineitem and partsupp on the part key, elements is the number of partsupp rows. Every part has 4
+ * suppliers, so the build side has 4 duplicates per key, lineitem has 7.5 rows per partsupp row like in TPC-H.
+ */
+static int run_join(uint32_t elements)
+{
+    const uint64_t parts = max(elements / JOIN_SUPPLIERS_PER_PART, 1u);
+    vector<uint64_t> partsupp(parts * JOIN_SUPPLIERS_PER_PART);
+    for (size_t i = 0; i < partsupp.size(); i++) {
+        partsupp[i] = i % parts;
+    }
+    mt19937_64 rng(42);
+    shuffle(partsupp.begin(), partsupp.end(), rng);
+    vector<uint64_t> lineitem(partsupp.size() * 15 / 2);
+    uniform_int_distribution<uint64_t> random_part(0, parts - 1);
+    for (uint64_t & part : lineitem) {
+        part = random_part(rng);
+    }
+    printf("partsupp rows (build): %zu\nlineitem rows (probe): %zu\n", partsupp.size(), lineitem.size());
+    printf("method\t\t\tbuild ms\tprobe ns per row\tchecksum\n");
+
+    {
+        unordered_multimap<uint64_t, size_t> umap;
+        double build_ns = measure_ns_per_op(1, [&]() {
+            umap.reserve(partsupp.size());
+            for (size_t i = 0; i < partsupp.size(); i++) {
+                umap.emplace(partsupp[i], i);
+            }
+        });
+        uint64_t sum = 0;
+        double probe_ns = measure_ns_per_op(lineitem.size(), [&]() {
+            for (size_t i = 0; i < lineitem.size(); i++) {
+                auto range = umap.equal_range(lineitem[i]);
+                for (auto it = range.first; it != range.second; ++it) {
+                    sum += it->second ^ i;
+                }
+            }
+        });
+        printf("unordered_multimap\t%.2f\t\t%.2f\t\t\t%lu\n", build_ns / 1e6, probe_ns, sum);
+    }
+
+    struct oha_hj_config config = {};
+    config.load_factor = 0.7;
+    config.key_size = sizeof(uint64_t);
+    struct oha_hj * join = NULL;
+    double build_ns = measure_ns_per_op(1, [&]() { join = oha_hj_create(&config, partsupp.data(), partsupp.size()); });
+    if (join == NULL) {
+        fprintf(stderr, "could not create hash join\n");
+        return 1;
+    }
+
+    uint64_t sum = 0;
+    double probe_ns = measure_ns_per_op(lineitem.size(), [&]() {
+        for (size_t i = 0; i < lineitem.size(); i++) {
+            for (size_t build_idx = oha_hj_find(join, &lineitem[i]); build_idx != OHA_HJ_END;
+                 build_idx = oha_hj_next(join, build_idx)) {
+                sum += build_idx ^ i;
+            }
+        }
+    });
+    printf("oha_hj_find\t\t%.2f\t\t%.2f\t\t\t%lu\n", build_ns / 1e6, probe_ns, sum);
+
+    sum = 0;
+    vector<struct oha_hj_match> matches(JOIN_OUTPUT_SIZE);
+    probe_ns = measure_ns_per_op(lineitem.size(), [&]() {
+        struct oha_hj_cursor cursor = {};
+        while (cursor.probe_idx < lineitem.size()) {
+            size_t n = oha_hj_probe(join, lineitem.data(), lineitem.size(), &cursor, matches.data(), matches.size());
+            for (size_t i = 0; i < n; i++) {
+                sum += matches[i].build_idx ^ matches[i].probe_idx;
+            }
+        }
+    });
+    printf("oha_hj_probe\t\t%.2f\t\t%.2f\t\t\t%lu\n", build_ns / 1e6, probe_ns, sum);
+    oha_hj_destroy(join);
+    return 0;
+}
+
+#define REHASH_KEY_SIZE 64
+
+/*
+ * Rehashes tables with long keys into the double capacity, with and without cached hashes. Look ups are measured, too,
+ * because the cached hash costs bucket memory.
+ */
+static int run_rehash(uint32_t elements)
+{
+    printf("key size: %d\nelements: %u\n", REHASH_KEY_SIZE, elements);
+    printf("cached hashes\trehash ms\tlook up ns\tsize MiB\n");
+    uint64_t sum = 0;
+    for (bool cache_hashes : {false, true}) {
+        struct oha_lpht_config config = {};
+        config.load_factor = 0.7;
+        config.key_size = REHASH_KEY_SIZE;
+        config.value_size = sizeof(uint64_t);
+        config.max_elems = elements;
+        config.cache_hashes = cache_hashes;
+        struct oha_lpht * table = oha_lpht_create(&config);
+        if (table == NULL) {
+            fprintf(stderr, "could not create table\n");
+            return 1;
+        }
+        uint8_t key[REHASH_KEY_SIZE] = {};
+        for (uint64_t i = 0; i < elements; i++) {
+            memcpy(key, &i, sizeof(i));
+            *(uint64_t *)oha_lpht_insert(table, key) = i;
+        }
+
+        double rehash_ns = measure_ns_per_op(1, [&]() { table = oha_lpht_rehash(table, 2 * elements, 0.0); });
+        if (table == NULL) {
+            fprintf(stderr, "could not rehash table\n");
+            return 1;
+        }
+
+        mt19937_64 rng(42);
+        uniform_int_distribution<uint64_t> random_key(0, elements - 1);
+        double look_up_ns = measure_ns_per_op(LOOK_UPS_PER_RUN, [&]() {
+            for (size_t i = 0; i < LOOK_UPS_PER_RUN; i++) {
+                uint64_t k = random_key(rng);
+                memcpy(key, &k, sizeof(k));
+                sum += *(uint64_t *)oha_lpht_look_up(table, key);
+            }
+        });
+
+        struct oha_lpht_status status;
+        oha_lpht_get_status(table, &status);
+        printf("%s\t\t%.2f\t\t%.2f\t\t%.1f\n",
+               cache_hashes ? "yes" : "no",
+               rehash_ns / 1e6,
+               look_up_ns,
+               status.size_in_bytes / (1024.0 * 1024.0));
+        oha_lpht_destroy(table);
+    }
+    printf("checksum: %lu\n", sum);
+    return 0;
+}
+
+/*
+ * Look ups of long keys, the default of 65536 elements keeps the table in the caches, so the hashing dominates.
+ */
+static int run_long_keys(uint32_t elements)
+{
+    printf("elements: %u\n", elements);
+    printf("key size\tlook up ns\n");
+    uint64_t sum = 0;
+    for (size_t key_size : {16, 64, 128, 256, 1024}) {
+        struct oha_lpht_config config = {};
+        config.load_factor = 0.7;
+        config.key_size = key_size;
+        config.value_size = sizeof(uint64_t);
+        config.max_elems = elements;
+        struct oha_lpht * table = oha_lpht_create(&config);
+        if (table == NULL) {
+            fprintf(stderr, "could not create table\n");
+            return 1;
+        }
+        vector<uint8_t> keys(key_size * elements);
+        mt19937_64 rng(42);
+        for (uint8_t & byte : keys) {
+            byte = rng();
+        }
+        for (uint32_t i = 0; i < elements; i++) {
+            *(uint64_t *)oha_lpht_insert(table, &keys[i * key_size]) = i;
+        }
+        vector<uint32_t> order(LOOK_UPS_PER_RUN);
+        uniform_int_distribution<uint32_t> random_index(0, elements - 1);
+        for (uint32_t & index : order) {
+            index = random_index(rng);
+        }
+        double ns = measure_ns_per_op(order.size(), [&]() {
+            for (uint32_t index : order) {
+                sum += *(uint64_t *)oha_lpht_look_up(table, &keys[index * key_size]);
+            }
+        });
+        printf("%zu\t\t%.2f\n", key_size, ns);
+        oha_lpht_destroy(table);
+    }
+    printf("checksum: %lu\n", sum);
+    return 0;
+}
+
+// parses the cpu list of a node, e.g. "0-3,8-11"
+static vector<int> get_node_cpus(int node)
+{
+    vector<int> cpus;
+    char path[128];
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+    FILE * fp = fopen(path, "r");
+    if (fp == NULL) {
+        for (unsigned int cpu = 0; cpu < thread::hardware_concurrency(); cpu++) {
+            cpus.push_back(cpu);
+        }
+        return cpus;
+    }
+    int first;
+    while (fscanf(fp, "%d", &first) == 1) {
+        int last = first;
+        int c = fgetc(fp);
+        if (c == '-') {
+            if (fscanf(fp, "%d", &last) != 1) {
+                break;
+            }
+            c = fgetc(fp);
+        }
+        for (int cpu = first; cpu <= last; cpu++) {
+            cpus.push_back(cpu);
+        }
+        if (c != ',') {
+            break;
+        }
+    }
+    fclose(fp);
+    return cpus;
+}
+
+// runs one pinned thread per cpu of the node, every thread looks up a slice of the keys, returns the Mops/s
+static double run_pinned_look_ups(struct oha_numa_lpht * table, const vector<int> & cpus, const vector<uint64_t> & keys)
+{
+    vector<thread> threads;
+    vector<uint64_t> found(cpus.size());
+    size_t slice = keys.size() / cpus.size();
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (size_t t = 0; t < cpus.size(); t++) {
+        threads.emplace_back([&, t]() {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpus[t], &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+            uint64_t hits = 0;
+            for (size_t i = t * slice; i < (t + 1) * slice; i++) {
+                hits += oha_numa_lpht_look_up(table, &keys[i]) != NULL;
+            }
+            found[t] = hits;
+        });
+    }
+    for (thread & t : threads) {
+        t.join();
+    }
+    chrono::duration<double, micro> elapsed = chrono::steady_clock::now() - start;
+    return slice * cpus.size() / elapsed.count();
+}
+
+/*
+ * Places one partition per node and pins threads to the cpus of every node. The threads look up keys of partitions on
+ * their own node (local) and of partitions on the other nodes (remote).
+ */
+static int run_numa(uint32_t elements, enum oha_numa_policy policy)
+{
+    struct oha_numa_config config = {};
+    config.table.load_factor = 0.7;
+    config.table.key_size = sizeof(uint64_t);
+    config.table.value_size = sizeof(struct value);
+    config.table.max_elems = elements;
+    config.policy = policy;
+
+    struct oha_numa_lpht * table = oha_numa_lpht_create(&config);
+    if (table == NULL) {
+        fprintf(stderr, "could not create the table\n");
+        return 1;
+    }
+    const uint32_t partitions = oha_numa_lpht_get_num_partitions(table);
+    const uint32_t nodes = oha_numa_get_num_nodes();
+    printf("nodes: %u\npartitions: %u\npolicy: %s\n",
+           nodes,
+           partitions,
+           policy == OHA_NUMA_PARTITIONED ? "partitioned" : "interleaved");
+
+    // keys grouped by the node of their partition, partition i is placed on the (i % nodes)-th online node
+    vector<vector<uint64_t>> node_keys(nodes);
+    for (uint64_t key = 0; key < elements; key++) {
+        memcpy(oha_numa_lpht_insert(table, &key), &key, sizeof(key));
+        node_keys[oha_numa_lpht_get_partition(table, &key) % nodes].push_back(key);
+    }
+    mt19937_64 rng(42);
+    for (vector<uint64_t> & keys : node_keys) {
+        shuffle(keys.begin(), keys.end(), rng);
+    }
+
+    printf("node\tthreads\tlocal Mops/s\tremote Mops/s\n");
+    for (uint32_t node = 0; node < nodes; node++) {
+        // sysfs node ids, the partitions are placed in the same order
+        int node_id = policy == OHA_NUMA_PARTITIONED ? oha_numa_lpht_get_partition_node(table, node) : (int)node;
+        vector<int> cpus = get_node_cpus(node_id);
+        double local = run_pinned_look_ups(table, cpus, node_keys[node]);
+        if (nodes == 1) {
+            printf("%d\t%zu\t%.2f\t\t-\n", node_id, cpus.size(), local);
+            continue;
+        }
+        double remote = run_pinned_look_ups(table, cpus, node_keys[(node + 1) % nodes]);
+        printf("%d\t%zu\t%.2f\t\t%.2f\n", node_id, cpus.size(), local, remote);
+    }
+
+    oha_numa_lpht_destroy(table);
+    return 0;
+}
+
+int main(int argc, char * argv[])
+{
+    if (argc < 2) {
+        fprintf(stderr,
+                "missing parameters. Use [mode] [elements]\n"
+                " mode:\n"
+                "   filter: look ups with and without bloom filter over a sweep of the hit ratio\n"
+                "   numa: node local and remote look ups of threads pinned per node into a NUMA partitioned table\n"
+                "   numa_interleaved: same as numa, but with interleaved pages\n"
+                "   interleaved: sequential, batch and coroutine interleaved look ups\n"
+                "   merge: merge of 32 partial aggregation tables, sequential and parallel\n"
+                "   rehash: rehash of long keys with and without cached hashes\n"
+                "   long_keys: look ups of 16 to 1024 byte keys, use a small number of elements\n"
+                "   join: TPC-H like join of lineitem and partsupp, elements are the partsupp rows\n"
+                "   aggregate: sum by key over a stream of 100M rows, std::unordered_map and lpht, elements are the groups\n"
+                " elements: table capacity, default %d\n"
+                " example: ./micro_benchmark filter 4000000\n",
+                DEFAULT_ELEMENTS);
+        return 1;
+    }
+    uint32_t elements = argc > 2 ? strtoul(argv[2], NULL, 10) : DEFAULT_ELEMENTS;
+    if (elements == 0) {
+        fprintf(stderr, "invalid number of elements %s\n", argv[2]);
+        return 1;
+    }
+
+    if (strcmp(argv[1], "filter") == 0) {
+        return run_filter(elements);
+    }
+    if (strcmp(argv[1], "interleaved") == 0) {
+        return run_interleaved(elements);
+    }
+    if (strcmp(argv[1], "merge") == 0) {
+        return run_merge(elements);
+    }
+    if (strcmp(argv[1], "aggregate") == 0) {
+        return run_aggregate(elements);
+    }
+    if (strcmp(argv[1], "long_keys") == 0) {
+        return run_long_keys(elements);
+    }
+    if (strcmp(argv[1], "join") == 0) {
+        return run_join(elements);
+    }
+    if (strcmp(argv[1], "rehash") == 0) {
+        return run_rehash(elements);
+    }
+    if (strcmp(argv[1], "numa") == 0) {
+        return run_numa(elements, OHA_NUMA_PARTITIONED);
+    }
+    if (strcmp(argv[1], "numa_interleaved") == 0) {
+        return run_numa(elements, OHA_NUMA_INTERLEAVED);
+    }
+    fprintf(stderr, "unsupported mode %s\n", argv[1]);
+    return 1;
+}
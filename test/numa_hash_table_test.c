@@ -0,0 +1,145 @@
+#include <stdlib.h>
+#include <unity.h>
+
+#include "oha.h"
+
+#define LOAF_FACTOR 0.9
+
+/* Is run before every test, put unit init calls here. */
+void setUp(void)
+{
+}
+/* Is run after every test, put unit clean-up calls here. */
+void tearDown(void)
+{
+}
+
+void test_num_nodes()
+{
+    TEST_ASSERT_TRUE(oha_numa_get_num_nodes() >= 1);
+}
+
+void test_create_destroy()
+{
+    struct oha_numa_config config = {
+        .table =
+            {
+                .load_factor = LOAF_FACTOR,
+                .key_size = sizeof(uint64_t),
+                .value_size = sizeof(uint64_t),
+                .max_elems = 100,
+            },
+        .policy = OHA_NUMA_PARTITIONED,
+    };
+    struct oha_numa_lpht * table = oha_numa_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+    TEST_ASSERT_EQUAL_UINT32(oha_numa_get_num_nodes(), oha_numa_lpht_get_num_partitions(table));
+    oha_numa_lpht_destroy(table);
+
+    // less elements than partitions
+    config.partitions = 101;
+    TEST_ASSERT_NULL(oha_numa_lpht_create(&config));
+    config.partitions = 0;
+    config.table.max_elems = 0;
+    TEST_ASSERT_NULL(oha_numa_lpht_create(&config));
+    oha_numa_lpht_destroy(NULL);
+}
+
+static void check_insert_look_up_remove(enum oha_numa_policy policy, uint32_t partitions)
+{
+    const struct oha_numa_config config = {
+        .table =
+            {
+                .load_factor = LOAF_FACTOR,
+                .key_size = sizeof(uint64_t),
+                .value_size = sizeof(uint64_t),
+                .max_elems = 10000,
+            },
+        .policy = policy,
+        .partitions = partitions,
+    };
+    struct oha_numa_lpht * table = oha_numa_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+    TEST_ASSERT_EQUAL_UINT32(partitions, oha_numa_lpht_get_num_partitions(table));
+
+    for (uint32_t p = 0; p < partitions; p++) {
+        int node = oha_numa_lpht_get_partition_node(table, p);
+        if (policy == OHA_NUMA_INTERLEAVED) {
+            TEST_ASSERT_EQUAL_INT(-1, node);
+        } else {
+            TEST_ASSERT_TRUE(node >= 0);
+        }
+        TEST_ASSERT_NOT_NULL(oha_numa_lpht_get_partition_table(table, p));
+    }
+    TEST_ASSERT_NULL(oha_numa_lpht_get_partition_table(table, partitions));
+
+    for (uint64_t i = 0; i < config.table.max_elems; i++) {
+        bool inserted;
+        uint64_t * value = oha_numa_lpht_insert_ex(table, &i, &inserted);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_TRUE(inserted);
+        *value = i;
+    }
+
+    uint32_t * per_partition = calloc(partitions, sizeof(uint32_t));
+    for (uint64_t i = 0; i < config.table.max_elems; i++) {
+        uint64_t * value = oha_numa_lpht_look_up(table, &i);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_EQUAL_UINT64(i, *value);
+
+        // the key is located in the partition of its route
+        uint32_t partition = oha_numa_lpht_get_partition(table, &i);
+        TEST_ASSERT_TRUE(partition < partitions);
+        TEST_ASSERT_EQUAL_PTR(value, oha_lpht_look_up(oha_numa_lpht_get_partition_table(table, partition), &i));
+        per_partition[partition]++;
+    }
+    for (uint32_t p = 0; p < partitions; p++) {
+        TEST_ASSERT_TRUE(per_partition[p] > 0);
+    }
+    free(per_partition);
+
+    struct oha_lpht_status status;
+    TEST_ASSERT_TRUE(oha_numa_lpht_get_status(table, &status));
+    TEST_ASSERT_EQUAL_UINT32(config.table.max_elems, status.elems_in_use);
+    TEST_ASSERT_TRUE(status.max_elems >= config.table.max_elems);
+
+    for (uint64_t i = 0; i < config.table.max_elems; i += 2) {
+        TEST_ASSERT_NOT_NULL(oha_numa_lpht_remove(table, &i));
+    }
+    for (uint64_t i = 0; i < config.table.max_elems; i++) {
+        uint64_t * value = oha_numa_lpht_look_up(table, &i);
+        if (i % 2 == 0) {
+            TEST_ASSERT_NULL(value);
+        } else {
+            TEST_ASSERT_NOT_NULL(value);
+        }
+    }
+    TEST_ASSERT_TRUE(oha_numa_lpht_get_status(table, &status));
+    TEST_ASSERT_EQUAL_UINT32(config.table.max_elems / 2, status.elems_in_use);
+
+    oha_numa_lpht_destroy(table);
+}
+
+void test_partitioned()
+{
+    check_insert_look_up_remove(OHA_NUMA_PARTITIONED, 1);
+    check_insert_look_up_remove(OHA_NUMA_PARTITIONED, 4);
+}
+
+void test_interleaved()
+{
+    check_insert_look_up_remove(OHA_NUMA_INTERLEAVED, 1);
+    check_insert_look_up_remove(OHA_NUMA_INTERLEAVED, 3);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_num_nodes);
+    RUN_TEST(test_create_destroy);
+    RUN_TEST(test_partitioned);
+    RUN_TEST(test_interleaved);
+
+    return UNITY_END();
+}
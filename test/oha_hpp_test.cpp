@@ -0,0 +1,197 @@
+#include <cstdlib>
+#include <unity.h>
+#include <vector>
+
+#include "oha.hpp"
+
+/* Is run before every test, put unit init calls here. */
+void setUp(void)
+{
+}
+/* Is run after every test, put unit clean-up calls here. */
+void tearDown(void)
+{
+}
+
+struct point {
+    int32_t x;
+    int32_t y;
+};
+
+struct point_hash {
+    uint64_t operator()(const point & p) const
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(p.x)) << 32 | static_cast<uint32_t>(p.y)) *
+               0x9e3779b97f4a7c15ULL;
+    }
+};
+
+void test_insert_find_erase()
+{
+    oha::lpht<uint64_t, uint64_t> table(1000, 0.9);
+    TEST_ASSERT_TRUE(table.empty());
+    TEST_ASSERT_EQUAL_UINT32(1000, table.max_size());
+
+    for (uint64_t i = 0; i < 1000; i++) {
+        std::pair<uint64_t *, bool> result = table.insert(i, i * 2);
+        TEST_ASSERT_NOT_NULL(result.first);
+        TEST_ASSERT_TRUE(result.second);
+    }
+    uint64_t full = 1000;
+    TEST_ASSERT_NULL(table.insert(full).first);
+
+    // already inserted keys keep their value
+    std::pair<uint64_t *, bool> result = table.insert(7, 0);
+    TEST_ASSERT_FALSE(result.second);
+    TEST_ASSERT_EQUAL_UINT64(14, *result.first);
+    TEST_ASSERT_EQUAL_UINT64(0, *table.insert_or_assign(7, 0));
+
+    for (uint64_t i = 0; i < 1000; i += 2) {
+        TEST_ASSERT_TRUE(table.erase(i));
+        TEST_ASSERT_FALSE(table.erase(i));
+    }
+    TEST_ASSERT_EQUAL_UINT32(500, table.size());
+    for (uint64_t i = 0; i < 1000; i++) {
+        TEST_ASSERT_EQUAL(i % 2 == 1, table.contains(i));
+    }
+}
+
+void test_iterate_erase_if()
+{
+    oha::lpht<uint32_t, point> table(100);
+    for (uint32_t i = 0; i < 100; i++) {
+        table.insert(i, point{static_cast<int32_t>(i), -static_cast<int32_t>(i)});
+    }
+
+    uint32_t count = 0;
+    uint64_t sum = 0;
+    for (std::pair<const uint32_t &, point &> element : table) {
+        TEST_ASSERT_EQUAL_INT32(element.first, element.second.x);
+        count++;
+        sum += element.first;
+    }
+    TEST_ASSERT_EQUAL_UINT32(100, count);
+    TEST_ASSERT_EQUAL_UINT64(99 * 100 / 2, sum);
+
+    uint32_t limit = 50;
+    TEST_ASSERT_EQUAL_UINT32(50, table.erase_if([limit](const uint32_t & key, point &) { return key < limit; }));
+    TEST_ASSERT_EQUAL_UINT32(50, table.size());
+    TEST_ASSERT_NULL(table.find(10));
+    TEST_ASSERT_EQUAL_INT32(-60, table.find(60)->y);
+}
+
+void test_custom_hash_and_move()
+{
+    oha::lpht<point, uint64_t, point_hash> table(200);
+    for (int32_t i = 0; i < 200; i++) {
+        TEST_ASSERT_TRUE(table.insert(point{i, i % 7}, static_cast<uint64_t>(i)).second);
+    }
+
+    oha::lpht<point, uint64_t, point_hash> moved(std::move(table));
+    TEST_ASSERT_NULL(table.get());
+    for (int32_t i = 0; i < 200; i++) {
+        uint64_t * value = moved.find(point{i, i % 7});
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_EQUAL_UINT64(i, *value);
+        TEST_ASSERT_NULL(moved.find(point{i, i % 7 + 1}));
+    }
+
+    oha::lpht<point, uint64_t, point_hash> other(1);
+    other = std::move(moved);
+    TEST_ASSERT_EQUAL_UINT32(200, other.size());
+}
+
+void test_merge()
+{
+    oha::lpht<uint32_t, uint64_t> a(100);
+    oha::lpht<uint32_t, uint64_t> b(100);
+    for (uint32_t i = 0; i < 60; i++) {
+        a.insert(i, 1);
+        b.insert(i + 40, 1);
+    }
+    oha::lpht<uint32_t, uint64_t> sum(100);
+    auto add = [](const uint32_t &, uint64_t & dst, const uint64_t & src) { dst += src; };
+    TEST_ASSERT_TRUE(sum.merge(a, add));
+    TEST_ASSERT_TRUE(sum.merge(b, add));
+    TEST_ASSERT_EQUAL_UINT32(100, sum.size());
+    TEST_ASSERT_EQUAL_UINT64(1, *sum.find(10));
+    TEST_ASSERT_EQUAL_UINT64(2, *sum.find(50));
+}
+
+void test_rehash()
+{
+    oha::lpht<uint32_t, uint64_t> table(1000);
+    for (uint32_t i = 0; i < 1000; i++) {
+        table.insert(i, i);
+    }
+    table.erase_if([](const uint32_t & key, uint64_t &) { return key >= 100; });
+    TEST_ASSERT_FALSE(table.rehash(99));
+    TEST_ASSERT_TRUE(table.rehash(200, 0.5));
+    TEST_ASSERT_EQUAL_UINT32(200, table.max_size());
+    TEST_ASSERT_EQUAL_UINT32(100, table.size());
+    for (uint32_t i = 0; i < 100; i++) {
+        TEST_ASSERT_EQUAL_UINT64(i, *table.find(i));
+    }
+}
+
+void test_find_batch()
+{
+    oha::lpht<uint64_t, uint64_t> table(1000);
+    for (uint64_t i = 0; i < 1000; i++) {
+        table.insert(i, i);
+    }
+    std::vector<uint64_t> keys;
+    for (uint64_t i = 0; i < 2000; i += 3) {
+        keys.push_back(i);
+    }
+    std::vector<uint64_t *> values(keys.size());
+    table.find_batch(keys.data(), keys.size(), values.data());
+    for (size_t i = 0; i < keys.size(); i++) {
+        TEST_ASSERT_EQUAL_PTR(table.find(keys[i]), values[i]);
+    }
+}
+
+void test_find_interleaved()
+{
+#ifdef OHA_WITH_COROUTINES
+    oha::lpht<uint64_t, uint64_t> table(1000);
+    for (uint64_t i = 0; i < 1000; i++) {
+        table.insert(i, i * 3);
+    }
+    std::vector<uint64_t> keys;
+    for (uint64_t i = 0; i < 2000; i += 3) {
+        keys.push_back(i);
+    }
+    std::vector<int> calls(keys.size());
+    oha::find_interleaved<8>(table, keys.data(), keys.size(), [&](size_t index, uint64_t * value) {
+        calls[index]++;
+        TEST_ASSERT_EQUAL_PTR(table.find(keys[index]), value);
+    });
+    for (int call : calls) {
+        TEST_ASSERT_EQUAL_INT(1, call);
+    }
+
+    // less keys than coroutines in flight
+    size_t found = 0;
+    oha::find_interleaved<32>(table, keys.data(), 5, [&](size_t, uint64_t * value) { found += value != nullptr; });
+    TEST_ASSERT_EQUAL(5, found);
+    oha::find_interleaved(table, keys.data(), 0, [&](size_t, uint64_t *) { TEST_FAIL(); });
+#else
+    TEST_IGNORE_MESSAGE("compiled without coroutine support");
+#endif
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_insert_find_erase);
+    RUN_TEST(test_iterate_erase_if);
+    RUN_TEST(test_custom_hash_and_move);
+    RUN_TEST(test_merge);
+    RUN_TEST(test_rehash);
+    RUN_TEST(test_find_batch);
+    RUN_TEST(test_find_interleaved);
+
+    return UNITY_END();
+}
@@ -0,0 +1,175 @@
+#include <stdlib.h>
+#include <unity.h>
+
+#include "oha.h"
+
+#define LOAF_FACTOR 0.7
+#define ROWS 10000
+#define GROUPS 1000
+
+/* Is run before every test, put unit init calls here. */
+void setUp(void)
+{
+}
+/* Is run after every test, put unit clean-up calls here. */
+void tearDown(void)
+{
+}
+
+static struct oha_rp_config get_config(uint32_t radix_bits)
+{
+    struct oha_rp_config config = {
+        .table =
+            {
+                .load_factor = LOAF_FACTOR,
+                .key_size = sizeof(uint64_t),
+                .value_size = sizeof(uint64_t),
+                .max_elems = GROUPS,
+            },
+        .radix_bits = radix_bits,
+    };
+    return config;
+}
+
+void test_create_destroy()
+{
+    struct oha_rp_config config = get_config(4);
+    struct oha_rp * rp = oha_rp_create(&config);
+    TEST_ASSERT_NOT_NULL(rp);
+    TEST_ASSERT_EQUAL_UINT32(16, oha_rp_get_num_partitions(rp));
+    TEST_ASSERT_NULL(oha_rp_get_table(rp, 16));
+    oha_rp_destroy(rp);
+
+    // small tables fit into one partition
+    config.radix_bits = 0;
+    rp = oha_rp_create(&config);
+    TEST_ASSERT_EQUAL_UINT32(1, oha_rp_get_num_partitions(rp));
+    oha_rp_destroy(rp);
+
+    // more partitions than elements
+    config.radix_bits = 11;
+    TEST_ASSERT_NULL(oha_rp_create(&config));
+    config.radix_bits = 15;
+    TEST_ASSERT_NULL(oha_rp_create(&config));
+    TEST_ASSERT_NULL(oha_rp_create(NULL));
+    oha_rp_destroy(NULL);
+}
+
+void test_auto_radix_bits()
+{
+    struct oha_rp_config config = get_config(0);
+    config.table.max_elems = 1000000;
+    struct oha_rp * rp = oha_rp_create(&config);
+    TEST_ASSERT_NOT_NULL(rp);
+    TEST_ASSERT_TRUE(oha_rp_get_num_partitions(rp) > 1);
+    struct oha_lpht_status status;
+    TEST_ASSERT_TRUE(oha_lpht_get_status(oha_rp_get_table(rp, 0), &status));
+    TEST_ASSERT_TRUE(status.size_in_bytes <= 256 * 1024);
+    oha_rp_destroy(rp);
+}
+
+// sums the rows per key in the partition tables and compares the sums and the row order
+static void check_aggregate(uint32_t radix_bits, bool with_values, bool key_from_value)
+{
+    struct oha_rp_config config = get_config(radix_bits);
+    config.table.key_from_value = key_from_value;
+    struct oha_rp * rp = oha_rp_create(&config);
+    TEST_ASSERT_NOT_NULL(rp);
+
+    uint64_t * keys = malloc(sizeof(uint64_t) * ROWS);
+    uint64_t * values = malloc(sizeof(uint64_t) * ROWS);
+    for (size_t i = 0; i < ROWS; i++) {
+        keys[i] = (i * 7919) % GROUPS;
+        values[i] = i;
+    }
+    // twice, the partition tables keep the sums
+    for (int run = 0; run < 2; run++) {
+        TEST_ASSERT_TRUE(oha_rp_partition(rp, keys, with_values ? values : NULL, ROWS));
+        size_t rows = 0;
+        for (uint32_t p = 0; p < oha_rp_get_num_partitions(rp); p++) {
+            const void * partition_keys;
+            const void * partition_values;
+            size_t n = oha_rp_get_rows(rp, p, &partition_keys, &partition_values);
+            TEST_ASSERT_EQUAL(with_values, partition_values != NULL);
+            struct oha_lpht * table = oha_rp_get_table(rp, p);
+            for (size_t i = 0; i < n; i++) {
+                const uint64_t * key = (const uint64_t *)partition_keys + i;
+                TEST_ASSERT_EQUAL_UINT32(p, oha_lpht_get_partition(table, key, oha_rp_get_num_partitions(rp)));
+                // the rows keep the input order inside of a partition
+                if (with_values) {
+                    uint64_t value = ((const uint64_t *)partition_values)[i];
+                    TEST_ASSERT_EQUAL_UINT64(keys[value], *key);
+                    if (i > 0) {
+                        TEST_ASSERT_TRUE(value > ((const uint64_t *)partition_values)[i - 1]);
+                    }
+                }
+            }
+            TEST_ASSERT_EQUAL(n, oha_lpht_add_u64_batch(table, partition_keys, partition_values, n));
+            rows += n;
+        }
+        TEST_ASSERT_EQUAL(ROWS, rows);
+    }
+
+    for (uint64_t key = 0; key < GROUPS; key++) {
+        uint64_t expected = 0;
+        for (size_t i = 0; i < ROWS; i++) {
+            if (keys[i] == key) {
+                expected += with_values ? 2 * values[i] : 2;
+            }
+        }
+        uint32_t partition = oha_lpht_get_partition(oha_rp_get_table(rp, 0), &key, oha_rp_get_num_partitions(rp));
+        uint64_t * sum = oha_lpht_look_up(oha_rp_get_table(rp, partition), &key);
+        TEST_ASSERT_NOT_NULL(sum);
+        TEST_ASSERT_EQUAL_UINT64(expected, *sum);
+        if (key_from_value) {
+            TEST_ASSERT_EQUAL_UINT64(
+                key, *(uint64_t *)oha_lpht_get_key_from_value(oha_rp_get_table(rp, partition), sum));
+        }
+    }
+    free(keys);
+    free(values);
+    oha_rp_destroy(rp);
+}
+
+void test_partition_aggregate()
+{
+    check_aggregate(1, true, false);
+    check_aggregate(4, true, false);
+    check_aggregate(6, false, false);
+    check_aggregate(4, true, true);
+
+    // no rows
+    struct oha_rp_config config = get_config(2);
+    struct oha_rp * rp = oha_rp_create(&config);
+    TEST_ASSERT_TRUE(oha_rp_partition(rp, NULL, NULL, 0));
+    const void * keys;
+    const void * values;
+    TEST_ASSERT_EQUAL(0, oha_rp_get_rows(rp, 0, &keys, &values));
+
+    // the values are allocated by the first call with values, after more rows without values
+    uint64_t row_keys[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    uint64_t row_values[4] = {10, 20, 30, 40};
+    TEST_ASSERT_TRUE(oha_rp_partition(rp, row_keys, NULL, 8));
+    TEST_ASSERT_TRUE(oha_rp_partition(rp, row_keys, row_values, 4));
+    size_t rows = 0;
+    for (uint32_t p = 0; p < oha_rp_get_num_partitions(rp); p++) {
+        size_t n = oha_rp_get_rows(rp, p, &keys, &values);
+        for (size_t i = 0; i < n; i++) {
+            TEST_ASSERT_EQUAL_UINT64(10 * ((const uint64_t *)keys)[i], ((const uint64_t *)values)[i]);
+        }
+        rows += n;
+    }
+    TEST_ASSERT_EQUAL(4, rows);
+    oha_rp_destroy(rp);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_create_destroy);
+    RUN_TEST(test_auto_radix_bits);
+    RUN_TEST(test_partition_aggregate);
+
+    return UNITY_END();
+}
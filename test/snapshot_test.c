@@ -0,0 +1,91 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unity.h>
+
+#include "oha.h"
+
+#define LOAF_FACTOR 0.9
+#define ELEMS 10000
+
+/* Is run before every test, put unit init calls here. */
+void setUp(void)
+{
+}
+/* Is run after every test, put unit clean-up calls here. */
+void tearDown(void)
+{
+}
+
+void test_cow_alloc_free()
+{
+    uint8_t * ptr = oha_cow_alloc(100000, NULL);
+    TEST_ASSERT_NOT_NULL(ptr);
+    TEST_ASSERT_EQUAL_UINT64(0, (uintptr_t)ptr % 64);
+    ptr[0] = 1;
+    ptr[99999] = 1;
+    oha_cow_free(ptr, NULL);
+    oha_cow_free(NULL, NULL);
+    TEST_ASSERT_NULL(oha_cow_alloc(0, NULL));
+}
+
+// the child process checks the table state of the fork time
+static int export_table(struct oha_lpht * table, void * context)
+{
+    (void)context;
+    for (uint64_t i = 0; i < ELEMS; i++) {
+        uint64_t * value = oha_lpht_look_up(table, &i);
+        if (value == NULL || *value != i) {
+            return 1;
+        }
+    }
+    struct oha_lpht_status status;
+    oha_lpht_get_status(table, &status);
+    return status.elems_in_use == ELEMS ? 0 : 2;
+}
+
+void test_fork_snapshot()
+{
+    const struct oha_lpht_config config = {
+        .load_factor = LOAF_FACTOR,
+        .key_size = sizeof(uint64_t),
+        .value_size = sizeof(uint64_t),
+        .max_elems = 2 * ELEMS,
+        .memory = oha_cow_get_memory_fp(),
+    };
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+    for (uint64_t i = 0; i < ELEMS; i++) {
+        *(uint64_t *)oha_lpht_insert(table, &i) = i;
+    }
+
+    int pid = oha_lpht_fork_snapshot(table, export_table, NULL);
+    TEST_ASSERT_TRUE(pid > 0);
+
+    // the writes of the parent are not visible in the snapshot
+    for (uint64_t i = 0; i < ELEMS; i += 2) {
+        TEST_ASSERT_NOT_NULL(oha_lpht_remove(table, &i));
+    }
+    for (uint64_t i = ELEMS; i < 2 * ELEMS; i++) {
+        *(uint64_t *)oha_lpht_insert(table, &i) = 0;
+    }
+
+    int status;
+    TEST_ASSERT_EQUAL_INT(pid, waitpid(pid, &status, 0));
+    TEST_ASSERT_TRUE(WIFEXITED(status));
+    TEST_ASSERT_EQUAL_INT(0, WEXITSTATUS(status));
+
+    TEST_ASSERT_EQUAL_INT(-1, oha_lpht_fork_snapshot(NULL, export_table, NULL));
+    oha_lpht_destroy(table);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_cow_alloc_free);
+    RUN_TEST(test_fork_snapshot);
+
+    return UNITY_END();
+}